@@ -0,0 +1,130 @@
+#include "Agent.h"
+#include "Autopilot.h"
+#include "Random.h"
+#include <cstdlib>
+
+namespace {
+
+const Direction ALL_DIRECTIONS[] = {UP, DOWN, LEFT, RIGHT};
+
+bool isReverse(Direction a, Direction b) {
+    return (a == UP && b == DOWN) || (a == DOWN && b == UP) ||
+           (a == LEFT && b == RIGHT) || (a == RIGHT && b == LEFT);
+}
+
+SnakeSegment nextHead(const GameSim& sim, Direction dir) {
+    SnakeSegment head = sim.getSnake().getHead();
+    int gridSize = sim.getGridSize();
+    switch (dir) {
+        case UP:
+            head.y -= gridSize;
+            break;
+        case DOWN:
+            head.y += gridSize;
+            break;
+        case LEFT:
+            head.x -= gridSize;
+            break;
+        case RIGHT:
+            head.x += gridSize;
+            break;
+    }
+    return head;
+}
+
+// Đi thẳng về phía mồi, tránh các nước đi chết ngay
+class GreedyAgent : public Agent {
+public:
+    const char* getName() const { return "greedy"; }
+    void reset(unsigned int) {}
+
+    Direction decide(const GameSim& sim) {
+        Point food = sim.getFood().getPosition();
+        Direction best = sim.getDirection();
+        int bestDistance = -1;
+
+        for (Direction dir : ALL_DIRECTIONS) {
+            if (isReverse(dir, sim.getDirection()) || !isSafeMove(sim, dir)) {
+                continue;
+            }
+
+            SnakeSegment head = nextHead(sim, dir);
+            int distance = abs(head.x - food.x) + abs(head.y - food.y);
+            if (bestDistance < 0 || distance < bestDistance) {
+                best = dir;
+                bestDistance = distance;
+            }
+        }
+
+        return best;
+    }
+};
+
+// Chọn ngẫu nhiên một nước đi an toàn
+class RandomAgent : public Agent {
+private:
+    Random random;
+
+public:
+    const char* getName() const { return "random"; }
+    // Stream riêng để không trùng dãy với mồi của cùng seed
+    void reset(unsigned int seed) { random.seed(seed, 1); }
+
+    Direction decide(const GameSim& sim) {
+        Direction safe[4];
+        int safeCount = 0;
+        for (Direction dir : ALL_DIRECTIONS) {
+            if (!isReverse(dir, sim.getDirection()) && isSafeMove(sim, dir)) {
+                safe[safeCount++] = dir;
+            }
+        }
+
+        if (safeCount == 0) {
+            return sim.getDirection();
+        }
+
+        return safe[random.nextBelow(safeCount)];
+    }
+};
+
+// BFS tới mồi có kiểm tra đường về đuôi, dự phòng bằng chu trình Hamilton
+class AutopilotAgent : public Agent {
+private:
+    Autopilot autopilot;
+
+public:
+    const char* getName() const { return "autopilot"; }
+    void reset(unsigned int) {}
+
+    Direction decide(const GameSim& sim) {
+        return autopilot.decide(sim);
+    }
+};
+
+}
+
+bool isSafeMove(const GameSim& sim, Direction dir) {
+    SnakeSegment head = nextHead(sim, dir);
+    if (head.x < 0 || head.x >= sim.getWorldWidth() ||
+        head.y < 0 || head.y >= sim.getWorldHeight()) {
+        return false;
+    }
+    return !sim.getSnake().isOccupied(head.x, head.y);
+}
+
+std::unique_ptr<Agent> createAgent(const std::string& name) {
+    if (name == "greedy") {
+        return std::unique_ptr<Agent>(new GreedyAgent());
+    }
+    if (name == "random") {
+        return std::unique_ptr<Agent>(new RandomAgent());
+    }
+    if (name == "autopilot") {
+        return std::unique_ptr<Agent>(new AutopilotAgent());
+    }
+    return nullptr;
+}
+
+std::vector<std::string> getAgentNames() {
+    return {"greedy", "random", "autopilot"};
+}
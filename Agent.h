@@ -0,0 +1,27 @@
+#ifndef AGENT_H
+#define AGENT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "GameSim.h"
+
+// Người chơi tự động: mỗi bước nhìn trạng thái GameSim và chọn hướng đi.
+// Mọi lựa chọn ngẫu nhiên đều lấy từ seed truyền vào reset() để ván đấu lặp lại được.
+class Agent {
+public:
+    virtual ~Agent() {}
+
+    virtual const char* getName() const = 0;
+    virtual void reset(unsigned int seed) = 0;
+    virtual Direction decide(const GameSim& sim) = 0;
+};
+
+// Tạo agent theo tên ("greedy", "random", "autopilot"), trả về nullptr nếu không có
+std::unique_ptr<Agent> createAgent(const std::string& name);
+std::vector<std::string> getAgentNames();
+
+// Ô kế tiếp theo hướng dir có an toàn không (không phải tường, không bị thân rắn chiếm)
+bool isSafeMove(const GameSim& sim, Direction dir);
+
+#endif // AGENT_H
@@ -0,0 +1,142 @@
+#include "ArenaClient.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ArenaClient::ArenaClient()
+    : fd(-1), joined(false), playerId(0), token(0), cols(0), rows(0), tickRate(0),
+      history(ARENA_SNAPSHOT_HISTORY), latestTick(0),
+      snapshots(0), bytesReceived(0), rejected(0) {
+}
+
+ArenaClient::~ArenaClient() {
+    close();
+}
+
+bool ArenaClient::open(const std::string& host, int port) {
+    close();
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || result == nullptr) {
+        std::cerr << "Không tìm được máy chủ " << host << std::endl;
+        return false;
+    }
+
+    // connect() cố định địa chỉ máy chủ: send/recv gọn hơn và bỏ gói từ nơi khác
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (fd < 0 || connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        std::cerr << "Không kết nối được tới " << host << ":" << port << ": " << strerror(errno) << std::endl;
+        freeaddrinfo(result);
+        close();
+        return false;
+    }
+    freeaddrinfo(result);
+
+    joined = false;
+    latestTick = 0;
+    for (NetSnapshot& snapshot : history) {
+        snapshot.tick = 0;
+    }
+    return true;
+}
+
+void ArenaClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    joined = false;
+}
+
+void ArenaClient::send(const uint8_t* data, size_t size) {
+    ::send(fd, data, size, 0);
+}
+
+void ArenaClient::join() {
+    uint8_t packet[2] = {ARENA_PACKET_JOIN, ARENA_PROTOCOL_VERSION};
+    send(packet, sizeof(packet));
+}
+
+void ArenaClient::leave() {
+    if (!joined) {
+        return;
+    }
+    uint8_t packet[8];
+    PacketWriter writer(packet, sizeof(packet));
+    writer.bytes(ARENA_PACKET_LEAVE, 1);
+    writer.bytes(playerId, 2);
+    writer.bytes(token, 4);
+    send(packet, writer.size());
+    joined = false;
+}
+
+void ArenaClient::sendInput(Direction direction) {
+    if (!joined) {
+        return;
+    }
+    uint8_t packet[16];
+    PacketWriter writer(packet, sizeof(packet));
+    writer.bytes(ARENA_PACKET_INPUT, 1);
+    writer.bytes(playerId, 2);
+    writer.bytes(token, 4);
+    writer.bytes(latestTick, 4);
+    writer.bytes(static_cast<uint64_t>(direction), 1);
+    send(packet, writer.size());
+}
+
+bool ArenaClient::receive() {
+    uint8_t packet[ARENA_MAX_PACKET];
+    bool updated = false;
+
+    while (true) {
+        ssize_t size = recv(fd, packet, sizeof(packet), MSG_DONTWAIT);
+        if (size <= 0) {
+            return updated;
+        }
+        bytesReceived += size;
+
+        PacketReader reader(packet, static_cast<size_t>(size));
+        uint8_t type = static_cast<uint8_t>(reader.bytes(1));
+        if (type == ARENA_PACKET_WELCOME) {
+            if (reader.bytes(1) != ARENA_PROTOCOL_VERSION) {
+                continue;
+            }
+            uint16_t id = static_cast<uint16_t>(reader.bytes(2));
+            uint32_t welcomeToken = static_cast<uint32_t>(reader.bytes(4));
+            int welcomeCols = static_cast<int>(reader.bytes(2));
+            int welcomeRows = static_cast<int>(reader.bytes(2));
+            int welcomeRate = static_cast<int>(reader.bytes(2));
+            if (reader.isOk()) {
+                playerId = id;
+                token = welcomeToken;
+                cols = welcomeCols;
+                rows = welcomeRows;
+                tickRate = welcomeRate;
+                joined = true;
+            }
+        } else if (type == ARENA_PACKET_SNAPSHOT && joined) {
+            uint32_t tick;
+            if (decodeSnapshot(packet, static_cast<size_t>(size), latestTick, history.data(), tick)) {
+                latestTick = tick;
+                snapshots++;
+                updated = true;
+            } else {
+                rejected++;
+            }
+        }
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,60 @@
+#ifndef ARENACLIENT_H
+#define ARENACLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ArenaProtocol.h"
+
+// Client UDP của snake_server: tham gia, gửi hướng đi kèm xác nhận snapshot,
+// giải mã snapshot chênh lệch dựa trên các snapshot đã nhận. Chỉ dùng trên Linux.
+class ArenaClient {
+private:
+    int fd;
+    bool joined;
+    uint16_t playerId;
+    uint32_t token;
+    int cols;
+    int rows;
+    int tickRate;
+
+    std::vector<NetSnapshot> history;   // Theo tick % ARENA_SNAPSHOT_HISTORY
+    uint32_t latestTick;                // 0: chưa có snapshot nào
+
+    long long snapshots;
+    long long bytesReceived;
+    long long rejected;                 // Gói hỏng hoặc thiếu base
+
+    void send(const uint8_t* data, size_t size);
+
+public:
+    ArenaClient();
+    ~ArenaClient();
+
+    bool open(const std::string& host, int port);
+    void close();
+
+    // Gửi JOIN; gọi lại (ví dụ mỗi giây) cho tới khi isJoined()
+    void join();
+    void leave();
+    // Đọc hết gói đang chờ, trả về true nếu có snapshot mới
+    bool receive();
+    // Hướng đi cho bước sau, kèm xác nhận snapshot mới nhất
+    void sendInput(Direction direction);
+
+    int getFd() const { return fd; }
+    bool isJoined() const { return joined; }
+    uint16_t getPlayerId() const { return playerId; }
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    int getTickRate() const { return tickRate; }
+    bool hasSnapshot() const { return latestTick != 0; }
+    const NetSnapshot& getSnapshot() const { return history[latestTick % ARENA_SNAPSHOT_HISTORY]; }
+
+    long long getSnapshotCount() const { return snapshots; }
+    long long getBytesReceived() const { return bytesReceived; }
+    long long getRejectedCount() const { return rejected; }
+};
+
+#endif // ARENACLIENT_H
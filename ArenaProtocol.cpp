@@ -0,0 +1,305 @@
+#include "ArenaProtocol.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Chỗ để dành cho phần mồi: danh sách mồi bị xóa luôn phải gửi đủ
+const size_t FOOD_RESERVE = 2 + ARENA_MAX_VISIBLE_FOODS + 1;
+
+const uint8_t SNAKE_FULL = 0;
+const uint8_t SNAKE_DELTA = 1;
+
+bool byId(const NetSnake& a, const NetSnake& b) {
+    return a.id < b.id;
+}
+
+const NetSnake* findSnake(const NetSnapshot& snapshot, uint16_t id) {
+    const NetSnake* begin = snapshot.snakes;
+    const NetSnake* end = snapshot.snakes + snapshot.snakeCount;
+    NetSnake key;
+    key.id = id;
+    const NetSnake* found = std::lower_bound(begin, end, key, byId);
+    return (found != end && found->id == id) ? found : nullptr;
+}
+
+// Trộn hai đoạn tăng dần foods[0, kept) và foods[kept, count) tại chỗ, không cấp phát
+void mergeFoods(uint32_t* foods, int kept, int count) {
+    uint32_t merged[ARENA_MAX_VISIBLE_FOODS];
+    int i = 0;
+    int j = kept;
+    int k = 0;
+    while (i < kept || j < count) {
+        merged[k++] = (j == count || (i < kept && foods[i] < foods[j])) ? foods[i++] : foods[j++];
+    }
+    memcpy(foods, merged, count * sizeof(uint32_t));
+}
+
+// Đoạn j = đoạn j + 1 đi theo hướng ngược của dirs[j]; từ ô đầu cũ (đoạn moves)
+// đi ngược lên tới ô đầu mới
+void walkToHead(const NetSnake& snake, int moves, uint16_t& x, uint16_t& y) {
+    for (int j = moves - 1; j >= 0; j--) {
+        switch (static_cast<Direction>(getNetDirection(snake, j) ^ 1)) {
+            case UP:
+                y--;
+                break;
+            case DOWN:
+                y++;
+                break;
+            case LEFT:
+                x--;
+                break;
+            case RIGHT:
+                x++;
+                break;
+        }
+    }
+}
+
+// Rắn vừa đi moves bước trong cùng một lượt sống: đầu mới, moves hướng mới ở đầu
+// chuỗi, phần còn lại là chuỗi cũ
+bool canDelta(const NetSnake& snake, const NetSnake* old, uint32_t moves) {
+    if (old == nullptr || old->life != snake.life || moves == 0 || moves >= snake.length ||
+        old->length + moves < snake.length || snake.score < old->score) {
+        return false;
+    }
+    uint16_t x = old->x;
+    uint16_t y = old->y;
+    walkToHead(snake, static_cast<int>(moves), x, y);
+    if (x != snake.x || y != snake.y) {
+        return false;
+    }
+    for (int j = static_cast<int>(moves); j < snake.length - 1; j++) {
+        if (getNetDirection(snake, j) != getNetDirection(*old, j - static_cast<int>(moves))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void encodeSnake(PacketWriter& writer, const NetSnake& snake, const NetSnake* old, uint32_t moves) {
+    writer.bytes(snake.id, 2);
+    if (canDelta(snake, old, moves)) {
+        writer.bytes(SNAKE_DELTA, 1);
+        writer.bytes(snake.length, 1);
+        writer.varint(static_cast<uint32_t>(snake.score - old->score));
+        writer.raw(snake.dirs, (moves + 3) / 4);
+        return;
+    }
+
+    writer.bytes(SNAKE_FULL, 1);
+    writer.bytes(snake.life, 2);
+    writer.bytes(snake.x, 2);
+    writer.bytes(snake.y, 2);
+    writer.bytes(snake.length, 1);
+    writer.varint(static_cast<uint32_t>(snake.score));
+    writer.raw(snake.dirs, (snake.length + 2) / 4);
+}
+
+bool decodeSnake(PacketReader& reader, const NetSnapshot* base, uint32_t moves, NetSnake& snake) {
+    snake.id = static_cast<uint16_t>(reader.bytes(2));
+    uint8_t kind = static_cast<uint8_t>(reader.bytes(1));
+    memset(snake.dirs, 0, sizeof(snake.dirs));
+
+    if (kind == SNAKE_FULL) {
+        snake.life = static_cast<uint16_t>(reader.bytes(2));
+        snake.x = static_cast<uint16_t>(reader.bytes(2));
+        snake.y = static_cast<uint16_t>(reader.bytes(2));
+        snake.length = static_cast<uint16_t>(reader.bytes(1));
+        snake.score = static_cast<int32_t>(reader.varint());
+        if (snake.length < 1 || snake.length > ARENA_MAX_SENT_SEGMENTS) {
+            return false;
+        }
+        reader.raw(snake.dirs, (snake.length + 2) / 4);
+        return reader.isOk();
+    }
+
+    const NetSnake* old = base != nullptr ? findSnake(*base, snake.id) : nullptr;
+    if (kind != SNAKE_DELTA || old == nullptr) {
+        return false;
+    }
+    snake.life = old->life;
+    snake.length = static_cast<uint16_t>(reader.bytes(1));
+    snake.score = old->score + static_cast<int32_t>(reader.varint());
+    if (snake.length > ARENA_MAX_SENT_SEGMENTS || moves >= snake.length || old->length + moves < snake.length) {
+        return false;
+    }
+    reader.raw(snake.dirs, (moves + 3) / 4);
+
+    // Byte cuối có thể còn bit rác sau moves hướng mới; ghi đè bằng chuỗi cũ
+    for (int j = static_cast<int>(moves); j < snake.length - 1; j++) {
+        setNetDirection(snake, j, getNetDirection(*old, j - static_cast<int>(moves)));
+    }
+    snake.x = old->x;
+    snake.y = old->y;
+    walkToHead(snake, static_cast<int>(moves), snake.x, snake.y);
+    return reader.isOk();
+}
+
+}
+
+size_t encodeSnapshot(const NetSnapshot& current, const NetSnapshot* base, uint8_t* out, NetSnapshot& sent) {
+    PacketWriter writer(out, ARENA_MAX_PACKET);
+    writer.bytes(ARENA_PACKET_SNAPSHOT, 1);
+    writer.bytes(current.tick, 4);
+    writer.bytes(base != nullptr ? base->tick : 0, 4);
+    writer.bytes(current.selfId, 2);
+    writer.bytes(current.selfAlive, 1);
+    writer.varint(static_cast<uint32_t>(current.selfScore));
+    writer.bytes(current.viewX, 2);
+    writer.bytes(current.viewY, 2);
+
+    sent.tick = current.tick;
+    sent.selfId = current.selfId;
+    sent.selfAlive = current.selfAlive;
+    sent.selfScore = current.selfScore;
+    sent.viewX = current.viewX;
+    sent.viewY = current.viewY;
+
+    // Rắn theo thứ tự ưu tiên, dừng khi hết chỗ
+    uint32_t moves = base != nullptr ? current.tick - base->tick : 0;
+    size_t countPos = writer.size();
+    writer.bytes(0, 1);
+    sent.snakeCount = 0;
+    for (int i = 0; i < current.snakeCount; i++) {
+        const NetSnake& snake = current.snakes[i];
+        size_t mark = writer.size();
+        encodeSnake(writer, snake, base != nullptr ? findSnake(*base, snake.id) : nullptr, moves);
+        if (!writer.isOk() || writer.size() > ARENA_MAX_PACKET - FOOD_RESERVE) {
+            writer.rewind(mark);
+            break;
+        }
+        sent.snakes[sent.snakeCount++] = snake;
+    }
+    writer.patch(countPos, static_cast<uint8_t>(sent.snakeCount));
+    std::sort(sent.snakes, sent.snakes + sent.snakeCount, byId);
+
+    // Mồi: chỉ số (trong base) của các mồi đã mất, rồi các mồi mới. Cả hai danh sách đều tăng dần.
+    int baseCount = base != nullptr ? base->foodCount : 0;
+    int removed = 0;
+    for (int i = 0, j = 0; i < baseCount; i++) {
+        while (j < current.foodCount && current.foods[j] < base->foods[i]) {
+            j++;
+        }
+        if (j == current.foodCount || current.foods[j] != base->foods[i]) {
+            removed++;
+        }
+    }
+
+    writer.varint(static_cast<uint32_t>(removed));
+    sent.foodCount = 0;
+    int previous = 0;
+    for (int i = 0, j = 0; i < baseCount; i++) {
+        while (j < current.foodCount && current.foods[j] < base->foods[i]) {
+            j++;
+        }
+        if (j == current.foodCount || current.foods[j] != base->foods[i]) {
+            writer.varint(static_cast<uint32_t>(i - previous));
+            previous = i;
+        } else {
+            sent.foods[sent.foodCount++] = base->foods[i];
+        }
+    }
+
+    size_t addedPos = writer.size();
+    writer.bytes(0, 1);
+    int kept = sent.foodCount;
+    int added = 0;
+    for (int j = 0, i = 0; j < current.foodCount && kept + added < ARENA_MAX_VISIBLE_FOODS; j++) {
+        while (i < kept && sent.foods[i] < current.foods[j]) {
+            i++;
+        }
+        if (i < kept && sent.foods[i] == current.foods[j]) {
+            continue;
+        }
+        size_t mark = writer.size();
+        writer.bytes(current.foods[j], 4);
+        if (!writer.isOk()) {
+            writer.rewind(mark);
+            break;
+        }
+        sent.foods[kept + added++] = current.foods[j];
+    }
+    writer.patch(addedPos, static_cast<uint8_t>(added));
+    sent.foodCount = kept + added;
+    mergeFoods(sent.foods, kept, sent.foodCount);
+
+    return writer.size();
+}
+
+bool decodeSnapshot(const uint8_t* data, size_t size, uint32_t latestTick, NetSnapshot* history, uint32_t& tick) {
+    PacketReader reader(data, size);
+    if (reader.bytes(1) != ARENA_PACKET_SNAPSHOT) {
+        return false;
+    }
+    tick = static_cast<uint32_t>(reader.bytes(4));
+    uint32_t baseTick = static_cast<uint32_t>(reader.bytes(4));
+    if (!reader.isOk() || static_cast<int32_t>(tick - latestTick) <= 0) {
+        return false;
+    }
+
+    const NetSnapshot* base = nullptr;
+    if (baseTick != 0) {
+        base = &history[baseTick % ARENA_SNAPSHOT_HISTORY];
+        if (base->tick != baseTick || tick - baseTick >= static_cast<uint32_t>(ARENA_SNAPSHOT_HISTORY)) {
+            return false;
+        }
+    }
+
+    // Slot bị hỏng giữa chừng không được dùng làm base
+    NetSnapshot& out = history[tick % ARENA_SNAPSHOT_HISTORY];
+    out.tick = 0;
+    out.selfId = static_cast<uint16_t>(reader.bytes(2));
+    out.selfAlive = static_cast<uint8_t>(reader.bytes(1));
+    out.selfScore = static_cast<int32_t>(reader.varint());
+    out.viewX = static_cast<uint16_t>(reader.bytes(2));
+    out.viewY = static_cast<uint16_t>(reader.bytes(2));
+
+    out.snakeCount = static_cast<int>(reader.bytes(1));
+    if (out.snakeCount > ARENA_MAX_VISIBLE_SNAKES) {
+        return false;
+    }
+    uint32_t moves = tick - baseTick;
+    for (int i = 0; i < out.snakeCount; i++) {
+        if (!decodeSnake(reader, base, moves, out.snakes[i])) {
+            return false;
+        }
+    }
+    std::sort(out.snakes, out.snakes + out.snakeCount, byId);
+
+    int baseCount = base != nullptr ? base->foodCount : 0;
+    uint64_t removed = reader.varint();
+    if (removed > static_cast<uint64_t>(baseCount)) {
+        return false;
+    }
+    out.foodCount = 0;
+    uint64_t skipped = 0;
+    uint64_t next = removed > 0 ? reader.varint() : baseCount;
+    for (int i = 0; i < baseCount; i++) {
+        if (static_cast<uint64_t>(i) == next) {
+            skipped++;
+            next = skipped < removed ? next + reader.varint() : baseCount;
+            continue;
+        }
+        out.foods[out.foodCount++] = base->foods[i];
+    }
+    if (skipped != removed) {
+        return false;
+    }
+
+    int kept = out.foodCount;
+    int added = static_cast<int>(reader.bytes(1));
+    if (kept + added > ARENA_MAX_VISIBLE_FOODS) {
+        return false;
+    }
+    for (int i = 0; i < added; i++) {
+        out.foods[out.foodCount++] = static_cast<uint32_t>(reader.bytes(4));
+    }
+    mergeFoods(out.foods, kept, out.foodCount);
+
+    if (!reader.isOk()) {
+        return false;
+    }
+    out.tick = tick;
+    return true;
+}
@@ -0,0 +1,182 @@
+#ifndef ARENAPROTOCOL_H
+#define ARENAPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GameSim.h"
+
+// Giao thức UDP giữa snake_server và client đấu trường.
+//
+// Client gửi JOIN cho tới khi nhận WELCOME (số hiệu người chơi, token), rồi mỗi
+// lần nhận snapshot thì gửi INPUT: hướng đi và bước (tick) mới nhất đã giải mã được.
+// Máy chủ gửi mỗi bước một SNAPSHOT chỉ gồm các rắn và mồi quanh khung nhìn của
+// người chơi, mã hóa chênh lệch so với snapshot client đã xác nhận gần nhất
+// (baseTick = 0 nghĩa là gửi đầy đủ). Rắn biểu diễn bằng ô đầu và chuỗi hướng
+// 2 bit giữa các đoạn liên tiếp, nên một rắn vừa đi m bước chỉ tốn m hướng mới.
+
+const uint8_t ARENA_PROTOCOL_VERSION = 1;
+const size_t ARENA_MAX_PACKET = 1200;           // Vừa một gói UDP mà không bị phân mảnh
+
+const int ARENA_VIEW_COLS = 40;                 // Bằng màn hình 800x600 với ô 20 điểm ảnh
+const int ARENA_VIEW_ROWS = 30;
+const int ARENA_VIEW_MARGIN = 4;                // Thêm quanh khung nhìn để rắn không hiện đột ngột
+
+const int ARENA_MAX_SENT_SEGMENTS = 64;         // Chỉ gửi phần thân gần đầu
+const int ARENA_MAX_VISIBLE_SNAKES = 48;
+const int ARENA_MAX_VISIBLE_FOODS = 96;
+const int ARENA_SNAPSHOT_HISTORY = 16;          // Snapshot cũ hơn thì gửi đầy đủ
+
+enum ArenaPacketType {
+    ARENA_PACKET_JOIN = 1,
+    ARENA_PACKET_INPUT = 2,
+    ARENA_PACKET_LEAVE = 3,
+    ARENA_PACKET_WELCOME = 11,
+    ARENA_PACKET_REJECT = 12,
+    ARENA_PACKET_SNAPSHOT = 13
+};
+
+// Một rắn trong snapshot, tọa độ theo ô
+struct NetSnake {
+    uint16_t id;
+    uint16_t life;      // ArenaSnake::life: khác nhau thì không mã hóa chênh lệch được
+    uint16_t x;
+    uint16_t y;
+    uint16_t length;    // Số đoạn đã gửi (tối đa ARENA_MAX_SENT_SEGMENTS)
+    int32_t score;
+    uint8_t dirs[ARENA_MAX_SENT_SEGMENTS / 4]; // length - 1 hướng, hướng i đi từ đoạn i tới đoạn i + 1
+};
+
+struct NetSnapshot {
+    uint32_t tick;
+    uint16_t selfId;
+    uint8_t selfAlive;
+    int32_t selfScore;
+    uint16_t viewX;     // Tâm khung nhìn
+    uint16_t viewY;
+    int snakeCount;
+    NetSnake snakes[ARENA_MAX_VISIBLE_SNAKES];  // Tăng dần theo id
+    int foodCount;
+    uint32_t foods[ARENA_MAX_VISIBLE_FOODS];    // (x << 16) | y, tăng dần
+};
+
+inline Direction getNetDirection(const NetSnake& snake, int index) {
+    return static_cast<Direction>((snake.dirs[index >> 2] >> ((index & 3) * 2)) & 3);
+}
+
+inline void setNetDirection(NetSnake& snake, int index, Direction dir) {
+    uint8_t& byte = snake.dirs[index >> 2];
+    byte = static_cast<uint8_t>((byte & ~(3 << ((index & 3) * 2))) | (dir << ((index & 3) * 2)));
+}
+
+// Ghi vào bộ đệm cố định, little-endian; tràn thì đánh dấu hỏng thay vì ghi quá
+class PacketWriter {
+private:
+    uint8_t* data;
+    size_t capacity;
+    size_t pos;
+    bool ok;
+
+public:
+    PacketWriter(uint8_t* data, size_t capacity) : data(data), capacity(capacity), pos(0), ok(true) {}
+
+    void bytes(uint64_t value, int count) {
+        if (!ok || capacity - pos < static_cast<size_t>(count)) {
+            ok = false;
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            data[pos++] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes((value & 0x7F) | 0x80, 1);
+            value >>= 7;
+        }
+        bytes(value, 1);
+    }
+
+    void raw(const uint8_t* source, size_t count) {
+        if (!ok || capacity - pos < count) {
+            ok = false;
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            data[pos++] = source[i];
+        }
+    }
+
+    // Quay lại vị trí cũ (bỏ phần vừa ghi) và ghi đè một byte đã ghi
+    void rewind(size_t position) {
+        pos = position;
+        ok = true;
+    }
+    void patch(size_t position, uint8_t value) { data[position] = value; }
+
+    size_t size() const { return pos; }
+    bool isOk() const { return ok; }
+};
+
+// Đọc tuần tự có kiểm tra biên; sau khi hỏng mọi lần đọc đều trả về 0
+class PacketReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+public:
+    PacketReader(const uint8_t* data, size_t size) : data(data), size(size), pos(0), ok(true) {}
+
+    uint64_t bytes(int count) {
+        if (!ok || size - pos < static_cast<size_t>(count)) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value |= static_cast<uint64_t>(data[pos++]) << (i * 8);
+        }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint64_t byte = bytes(1);
+            value |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    void raw(uint8_t* target, size_t count) {
+        if (!ok || size - pos < count) {
+            ok = false;
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            target[i] = data[pos++];
+        }
+    }
+
+    bool isOk() const { return ok; }
+};
+
+// Mã hóa current (rắn xếp theo thứ tự ưu tiên, gần người chơi trước) so với base
+// (nullptr: đầy đủ) vào tối đa ARENA_MAX_PACKET byte. Rắn hay mồi không còn chỗ
+// thì bỏ qua ở bước này. sent nhận đúng những gì đã gửi (xếp lại theo id), để
+// làm base cho các bước sau. Trả về số byte đã ghi.
+size_t encodeSnapshot(const NetSnapshot& current, const NetSnapshot* base, uint8_t* out, NetSnapshot& sent);
+
+// Giải mã gói snapshot (cả byte loại gói) vào history[tick % ARENA_SNAPSHOT_HISTORY];
+// history là vòng các snapshot đã giải mã, base được tìm ở đó. Gói không mới hơn
+// latestTick bị bỏ qua. Trả về false nếu gói cũ, hỏng hoặc không còn base.
+bool decodeSnapshot(const uint8_t* data, size_t size, uint32_t latestTick, NetSnapshot* history, uint32_t& tick);
+
+#endif // ARENAPROTOCOL_H
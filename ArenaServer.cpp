@@ -0,0 +1,504 @@
+#include "ArenaServer.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+const int TIMEOUT_SECONDS = 5;
+const int RECEIVE_PACKET_SIZE = 256;    // Gói từ client đều nhỏ
+const int SOCKET_BUFFER_BYTES = 4 << 20;
+
+uint64_t addressKey(uint32_t address, uint16_t port) {
+    return (static_cast<uint64_t>(address) << 16) | port;
+}
+
+sockaddr_in makeAddress(uint32_t address, uint16_t port) {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = address;
+    addr.sin_port = port;
+    return addr;
+}
+
+}
+
+ArenaServer::ArenaServer(int cols, int rows, int maxPlayers, int foodCount, int tickRate)
+    : fd(-1), port(0), tickRate(tickRate), timeoutTicks(std::max(1, tickRate) * TIMEOUT_SECONDS),
+      arena(cols, rows, maxPlayers, foodCount), random(static_cast<uint64_t>(time(nullptr))),
+      clients(maxPlayers), actions(maxPlayers, RIGHT),
+      bucketCols((cols + BUCKET_SIZE - 1) / BUCKET_SIZE), bucketRows((rows + BUCKET_SIZE - 1) / BUCKET_SIZE),
+      snakeStart(bucketCols * bucketRows + 1), snakeItems(maxPlayers),
+      foodStart(bucketCols * bucketRows + 1), foodItems(foodCount),
+      receiveBuffer(BATCH * RECEIVE_PACKET_SIZE),
+      sendBuffer(static_cast<size_t>(BATCH) * ARENA_MAX_PACKET),
+      sendAddresses(BATCH), sendPorts(BATCH), sendSizes(BATCH), sendCount(0), statsResetRequested(false) {
+    // Mọi rắn tắt cho tới khi có người chơi
+    for (int i = maxPlayers - 1; i >= 0; i--) {
+        arena.setEnabled(i, false);
+        clients[i].active = false;
+        freeSlots.push_back(i);
+    }
+    arena.reset(static_cast<unsigned int>(random.next()));
+    candidates.reserve(maxPlayers);
+    resetStats();
+}
+
+ArenaServer::~ArenaServer() {
+    close();
+}
+
+bool ArenaServer::open(int port) {
+    close();
+
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        std::cerr << "Không tạo được socket UDP: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Mỗi bước nhận một gói từ mọi người chơi cùng lúc
+    int bufferBytes = SOCKET_BUFFER_BYTES;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+
+    sockaddr_in addr = makeAddress(htonl(INADDR_ANY), htons(static_cast<uint16_t>(port)));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "Không mở được cổng " << port << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    this->port = ntohs(addr.sin_port);
+    return true;
+}
+
+void ArenaServer::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void ArenaServer::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+    for (Client& client : clients) {
+        client.bytesSent = 0;
+    }
+}
+
+void ArenaServer::receive() {
+    mmsghdr messages[BATCH];
+    iovec vectors[BATCH];
+    sockaddr_in addresses[BATCH];
+
+    while (true) {
+        for (int i = 0; i < BATCH; i++) {
+            vectors[i].iov_base = &receiveBuffer[i * RECEIVE_PACKET_SIZE];
+            vectors[i].iov_len = RECEIVE_PACKET_SIZE;
+            memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+        }
+
+        int count = recvmmsg(fd, messages, BATCH, MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            handlePacket(&receiveBuffer[i * RECEIVE_PACKET_SIZE], messages[i].msg_len,
+                         addresses[i].sin_addr.s_addr, addresses[i].sin_port);
+        }
+        if (count < BATCH) {
+            return;
+        }
+    }
+}
+
+void ArenaServer::handlePacket(const uint8_t* data, size_t size, uint32_t address, uint16_t port) {
+    PacketReader reader(data, size);
+    uint8_t type = static_cast<uint8_t>(reader.bytes(1));
+
+    std::unordered_map<uint64_t, int>::const_iterator found = byAddress.find(addressKey(address, port));
+    if (type == ARENA_PACKET_JOIN) {
+        if (reader.bytes(1) != ARENA_PROTOCOL_VERSION || !reader.isOk()) {
+            return;
+        }
+        if (found != byAddress.end()) {
+            // WELCOME trước bị mất
+            sendWelcome(found->second);
+        } else {
+            join(address, port);
+        }
+        return;
+    }
+
+    if (found == byAddress.end()) {
+        return;
+    }
+    int slot = found->second;
+    Client& client = clients[slot];
+    uint16_t id = static_cast<uint16_t>(reader.bytes(2));
+    uint32_t token = static_cast<uint32_t>(reader.bytes(4));
+    if (!reader.isOk() || id != slot || token != client.token) {
+        return;
+    }
+
+    client.lastHeard = arena.getTick();
+    if (type == ARENA_PACKET_INPUT) {
+        uint32_t ack = static_cast<uint32_t>(reader.bytes(4));
+        uint8_t dir = static_cast<uint8_t>(reader.bytes(1));
+        if (!reader.isOk()) {
+            return;
+        }
+        if (dir <= RIGHT) {
+            client.input = static_cast<Direction>(dir);
+        }
+        // Gói đến trễ có thể mang ack cũ hơn
+        if (ack <= static_cast<uint32_t>(arena.getTick()) && static_cast<int32_t>(ack - client.ackTick) > 0) {
+            client.ackTick = ack;
+        }
+    } else if (type == ARENA_PACKET_LEAVE) {
+        removeClient(slot);
+    }
+}
+
+void ArenaServer::join(uint32_t address, uint16_t port) {
+    if (freeSlots.empty()) {
+        uint8_t reject = ARENA_PACKET_REJECT;
+        sendNow(&reject, 1, address, port);
+        return;
+    }
+
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    byAddress[addressKey(address, port)] = slot;
+
+    Client& client = clients[slot];
+    client.active = true;
+    client.address = address;
+    client.port = port;
+    client.token = random.next();
+    client.input = arena.getSnake(slot).direction;
+    client.ackTick = 0;
+    client.lastHeard = arena.getTick();
+    client.viewX = static_cast<uint16_t>(arena.getCols() / 2);
+    client.viewY = static_cast<uint16_t>(arena.getRows() / 2);
+    client.history.resize(ARENA_SNAPSHOT_HISTORY);
+    for (NetSnapshot& snapshot : client.history) {
+        snapshot.tick = 0;
+    }
+    client.bytesSent = 0;
+
+    arena.setEnabled(slot, true);
+    sendWelcome(slot);
+}
+
+void ArenaServer::removeClient(int slot) {
+    Client& client = clients[slot];
+    byAddress.erase(addressKey(client.address, client.port));
+    client.active = false;
+    arena.setEnabled(slot, false);
+    freeSlots.push_back(slot);
+}
+
+void ArenaServer::sendWelcome(int slot) {
+    const Client& client = clients[slot];
+    uint8_t packet[32];
+    PacketWriter writer(packet, sizeof(packet));
+    writer.bytes(ARENA_PACKET_WELCOME, 1);
+    writer.bytes(ARENA_PROTOCOL_VERSION, 1);
+    writer.bytes(static_cast<uint64_t>(slot), 2);
+    writer.bytes(client.token, 4);
+    writer.bytes(static_cast<uint64_t>(arena.getCols()), 2);
+    writer.bytes(static_cast<uint64_t>(arena.getRows()), 2);
+    writer.bytes(static_cast<uint64_t>(tickRate), 2);
+    sendNow(packet, writer.size(), client.address, client.port);
+}
+
+void ArenaServer::sendNow(const uint8_t* data, size_t size, uint32_t address, uint16_t port) {
+    sockaddr_in addr = makeAddress(address, port);
+    sendto(fd, data, size, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+void ArenaServer::buildBuckets() {
+    // Đếm, cộng dồn rồi đặt: O(số rắn + số mồi + số ô thô), không cấp phát
+    int bucketCount = bucketCols * bucketRows;
+    std::fill(snakeStart.begin(), snakeStart.end(), 0);
+    std::fill(foodStart.begin(), foodStart.end(), 0);
+
+    for (int i = 0; i < arena.getSnakeCount(); i++) {
+        const ArenaSnake& snake = arena.getSnake(i);
+        if (snake.alive) {
+            const SnakeSegment& head = snake.body.front();
+            snakeStart[(head.y / BUCKET_SIZE) * bucketCols + head.x / BUCKET_SIZE + 1]++;
+        }
+    }
+    for (int i = 0; i < arena.getFoodCount(); i++) {
+        Point food = arena.getFood(i);
+        if (food.x >= 0) {
+            foodStart[(food.y / BUCKET_SIZE) * bucketCols + food.x / BUCKET_SIZE + 1]++;
+        }
+    }
+    for (int b = 0; b < bucketCount; b++) {
+        snakeStart[b + 1] += snakeStart[b];
+        foodStart[b + 1] += foodStart[b];
+    }
+
+    // Dùng start[b] làm con trỏ ghi rồi lùi lại một ô
+    for (int i = 0; i < arena.getSnakeCount(); i++) {
+        const ArenaSnake& snake = arena.getSnake(i);
+        if (snake.alive) {
+            const SnakeSegment& head = snake.body.front();
+            snakeItems[snakeStart[(head.y / BUCKET_SIZE) * bucketCols + head.x / BUCKET_SIZE]++] = i;
+        }
+    }
+    for (int i = 0; i < arena.getFoodCount(); i++) {
+        Point food = arena.getFood(i);
+        if (food.x >= 0) {
+            foodItems[foodStart[(food.y / BUCKET_SIZE) * bucketCols + food.x / BUCKET_SIZE]++] = i;
+        }
+    }
+    for (int b = bucketCount; b > 0; b--) {
+        snakeStart[b] = snakeStart[b - 1];
+        foodStart[b] = foodStart[b - 1];
+    }
+    snakeStart[0] = 0;
+    foodStart[0] = 0;
+}
+
+void ArenaServer::fillSnake(int index, NetSnake& snake) const {
+    const ArenaSnake& source = arena.getSnake(index);
+    const SnakeBody& body = source.body;
+    snake.id = static_cast<uint16_t>(index);
+    snake.life = static_cast<uint16_t>(source.life);
+    snake.x = static_cast<uint16_t>(body.front().x);
+    snake.y = static_cast<uint16_t>(body.front().y);
+    snake.score = source.score;
+    memset(snake.dirs, 0, sizeof(snake.dirs));
+
+    // Chuỗi hướng dừng ở đoạn đuôi bị nhân đôi sau khi ăn
+    int length = 1;
+    for (size_t i = 1; i < body.size() && length < ARENA_MAX_SENT_SEGMENTS; i++) {
+        const SnakeSegment& previous = body[i - 1];
+        const SnakeSegment& segment = body[i];
+        Direction dir;
+        if (segment.x > previous.x) {
+            dir = RIGHT;
+        } else if (segment.x < previous.x) {
+            dir = LEFT;
+        } else if (segment.y > previous.y) {
+            dir = DOWN;
+        } else if (segment.y < previous.y) {
+            dir = UP;
+        } else {
+            break;
+        }
+        setNetDirection(snake, length - 1, dir);
+        length++;
+    }
+    snake.length = static_cast<uint16_t>(length);
+}
+
+void ArenaServer::buildSnapshot(int slot) {
+    Client& client = clients[slot];
+    const ArenaSnake& self = arena.getSnake(slot);
+    if (self.alive) {
+        client.viewX = static_cast<uint16_t>(self.body.front().x);
+        client.viewY = static_cast<uint16_t>(self.body.front().y);
+    }
+
+    current.tick = static_cast<uint32_t>(arena.getTick());
+    current.selfId = static_cast<uint16_t>(slot);
+    current.selfAlive = self.alive ? 1 : 0;
+    current.selfScore = self.score;
+    current.viewX = client.viewX;
+    current.viewY = client.viewY;
+
+    int left = client.viewX - ARENA_VIEW_COLS / 2 - ARENA_VIEW_MARGIN;
+    int right = client.viewX + ARENA_VIEW_COLS / 2 + ARENA_VIEW_MARGIN;
+    int top = client.viewY - ARENA_VIEW_ROWS / 2 - ARENA_VIEW_MARGIN;
+    int bottom = client.viewY + ARENA_VIEW_ROWS / 2 + ARENA_VIEW_MARGIN;
+    int firstCol = std::max(0, left / BUCKET_SIZE);
+    int lastCol = std::min(bucketCols - 1, right / BUCKET_SIZE);
+    int firstRow = std::max(0, top / BUCKET_SIZE);
+    int lastRow = std::min(bucketRows - 1, bottom / BUCKET_SIZE);
+
+    // Rắn có đầu trong khung nhìn, gần trước (khoảng cách << 16 | chỉ số); rắn của mình luôn đầu tiên
+    candidates.clear();
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            int bucket = row * bucketCols + col;
+            for (int k = snakeStart[bucket]; k < snakeStart[bucket + 1]; k++) {
+                int index = snakeItems[k];
+                const SnakeSegment& head = arena.getSnake(index).body.front();
+                if (head.x < left || head.x > right || head.y < top || head.y > bottom) {
+                    continue;
+                }
+                uint32_t distance = index == slot ? 0 : 1 + abs(head.x - client.viewX) + abs(head.y - client.viewY);
+                candidates.push_back((distance << 16) | static_cast<uint32_t>(index));
+            }
+        }
+    }
+    size_t count = std::min(candidates.size(), static_cast<size_t>(ARENA_MAX_VISIBLE_SNAKES));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    current.snakeCount = static_cast<int>(count);
+    for (size_t i = 0; i < count; i++) {
+        fillSnake(static_cast<int>(candidates[i] & 0xFFFF), current.snakes[i]);
+    }
+
+    current.foodCount = 0;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            int bucket = row * bucketCols + col;
+            for (int k = foodStart[bucket]; k < foodStart[bucket + 1] && current.foodCount < ARENA_MAX_VISIBLE_FOODS; k++) {
+                Point food = arena.getFood(foodItems[k]);
+                if (food.x >= left && food.x <= right && food.y >= top && food.y <= bottom) {
+                    current.foods[current.foodCount++] = (static_cast<uint32_t>(food.x) << 16) | static_cast<uint32_t>(food.y);
+                }
+            }
+        }
+    }
+    std::sort(current.foods, current.foods + current.foodCount);
+}
+
+void ArenaServer::flush() {
+    mmsghdr messages[BATCH];
+    iovec vectors[BATCH];
+    sockaddr_in addresses[BATCH];
+    for (int i = 0; i < sendCount; i++) {
+        vectors[i].iov_base = &sendBuffer[static_cast<size_t>(i) * ARENA_MAX_PACKET];
+        vectors[i].iov_len = sendSizes[i];
+        addresses[i] = makeAddress(sendAddresses[i], sendPorts[i]);
+        memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+    }
+
+    // UDP: gói không gửi được thì bỏ, client sẽ nhận snapshot sau
+    int sent = 0;
+    while (sent < sendCount) {
+        int count = sendmmsg(fd, messages + sent, sendCount - sent, 0);
+        if (count <= 0) {
+            break;
+        }
+        sent += count;
+    }
+    sendCount = 0;
+}
+
+void ArenaServer::tick() {
+    if (statsResetRequested.exchange(false)) {
+        resetStats();
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    receive();
+
+    int count = arena.getSnakeCount();
+    for (int i = 0; i < count; i++) {
+        actions[i] = clients[i].active ? clients[i].input : arena.getSnake(i).direction;
+    }
+    arena.step(actions.data());
+    uint32_t tick = static_cast<uint32_t>(arena.getTick());
+
+    for (int i = 0; i < count; i++) {
+        if (clients[i].active && arena.getTick() - clients[i].lastHeard > timeoutTicks) {
+            removeClient(i);
+        }
+    }
+
+    buildBuckets();
+    int players = 0;
+    for (int i = 0; i < count; i++) {
+        Client& client = clients[i];
+        if (!client.active) {
+            continue;
+        }
+        players++;
+
+        buildSnapshot(i);
+        const NetSnapshot* base = nullptr;
+        if (client.ackTick != 0 && tick - client.ackTick < static_cast<uint32_t>(ARENA_SNAPSHOT_HISTORY)) {
+            const NetSnapshot& acked = client.history[client.ackTick % ARENA_SNAPSHOT_HISTORY];
+            if (acked.tick == client.ackTick) {
+                base = &acked;
+            }
+        }
+
+        uint8_t* packet = &sendBuffer[static_cast<size_t>(sendCount) * ARENA_MAX_PACKET];
+        size_t size = encodeSnapshot(current, base, packet, client.history[tick % ARENA_SNAPSHOT_HISTORY]);
+        sendAddresses[sendCount] = client.address;
+        sendPorts[sendCount] = client.port;
+        sendSizes[sendCount] = static_cast<int>(size);
+        if (++sendCount == BATCH) {
+            flush();
+        }
+
+        client.bytesSent += size;
+        stats.bytesSent += size;
+        stats.snapshots++;
+        if (base == nullptr) {
+            stats.fullSnapshots++;
+        }
+    }
+    flush();
+
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    stats.ticks++;
+    stats.clientTicks += players;
+    stats.busyMicros += micros;
+    stats.maxTickMicros = std::max(stats.maxTickMicros, micros);
+}
+
+void ArenaServer::run(const std::atomic<bool>* stop) {
+    std::chrono::steady_clock::duration period = tickRate > 0
+        ? std::chrono::steady_clock::duration(std::chrono::seconds(1)) / tickRate
+        : std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    while (stop == nullptr || !stop->load()) {
+        tick();
+        next += period;
+
+        // Giữa hai bước vẫn nhận gói để hàng đợi socket không đầy
+        while (true) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now >= next) {
+                break;
+            }
+            int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count());
+            pollfd entry = {fd, POLLIN, 0};
+            if (poll(&entry, 1, std::max(1, waitMs)) > 0) {
+                receive();
+            }
+        }
+
+        // Chậm quá một bước thì không cố đuổi kịp
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - next > period) {
+            next = now;
+        }
+    }
+}
+
+#endif // __linux__
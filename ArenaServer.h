@@ -0,0 +1,118 @@
+#ifndef ARENASERVER_H
+#define ARENASERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ArenaProtocol.h"
+#include "ArenaSim.h"
+#include "Random.h"
+
+struct ArenaServerStats {
+    long long ticks;
+    long long clientTicks;      // Tổng số người chơi qua các bước (để tính trung bình mỗi người)
+    double busyMicros;          // Thời gian xử lý các bước, không tính lúc ngủ chờ
+    double maxTickMicros;
+    long long bytesSent;        // Chỉ phần dữ liệu UDP
+    long long snapshots;
+    long long fullSnapshots;
+};
+
+// Máy chủ đấu trường qua UDP: ArenaSim là nguồn sự thật duy nhất, chạy theo bước
+// cố định. Mỗi người chơi điều khiển một rắn trong ArenaSim; chỗ trống thì rắn bị tắt.
+//
+// Mỗi bước, mỗi người chơi nhận một snapshot chỉ gồm rắn và mồi quanh khung nhìn
+// của mình, mã hóa chênh lệch với snapshot họ đã xác nhận (xem ArenaProtocol.h).
+// Đầu rắn và mồi được xếp vào các ô lưới thô BUCKET_SIZE x BUCKET_SIZE, nên tìm
+// những gì gần một người chơi chỉ tốn theo số thứ quanh họ: chi phí và băng thông
+// mỗi người chơi không đổi khi tổng số người chơi tăng mà mật độ giữ nguyên.
+// Chỉ dùng trên Linux (recvmmsg/sendmmsg).
+class ArenaServer {
+private:
+    static const int BUCKET_SIZE = 16;
+    static const int BATCH = 64;
+
+    struct Client {
+        bool active;
+        uint32_t address;       // Theo thứ tự byte mạng
+        uint16_t port;
+        uint32_t token;
+        Direction input;
+        uint32_t ackTick;
+        int lastHeard;          // Bước nhận gói gần nhất
+        uint16_t viewX;
+        uint16_t viewY;
+        std::vector<NetSnapshot> history;   // Snapshot đã gửi, theo tick % ARENA_SNAPSHOT_HISTORY
+        long long bytesSent;
+    };
+
+    int fd;
+    int port;
+    int tickRate;
+    int timeoutTicks;
+    ArenaSim arena;
+    Random random;
+    std::vector<Client> clients;    // Chỉ số trùng với chỉ số rắn trong arena
+    std::vector<int> freeSlots;
+    std::unordered_map<uint64_t, int> byAddress;
+    std::vector<Direction> actions;
+
+    // Lưới thô theo dạng CSR: phần tử của ô b nằm trong items[start[b], start[b + 1])
+    int bucketCols;
+    int bucketRows;
+    std::vector<int> snakeStart;
+    std::vector<int> snakeItems;
+    std::vector<int> foodStart;
+    std::vector<int> foodItems;
+
+    std::vector<uint32_t> candidates;
+    NetSnapshot current;
+
+    // Bộ đệm nhận/gửi theo lô
+    std::vector<uint8_t> receiveBuffer;
+    std::vector<uint8_t> sendBuffer;
+    std::vector<uint32_t> sendAddresses;
+    std::vector<uint16_t> sendPorts;
+    std::vector<int> sendSizes;
+    int sendCount;
+
+    ArenaServerStats stats;
+    std::atomic<bool> statsResetRequested;
+
+    void receive();
+    void handlePacket(const uint8_t* data, size_t size, uint32_t address, uint16_t port);
+    void join(uint32_t address, uint16_t port);
+    void removeClient(int slot);
+    void sendWelcome(int slot);
+    void sendNow(const uint8_t* data, size_t size, uint32_t address, uint16_t port);
+    void buildBuckets();
+    void buildSnapshot(int slot);
+    void fillSnake(int index, NetSnake& snake) const;
+    void flush();
+
+public:
+    ArenaServer(int cols, int rows, int maxPlayers, int foodCount, int tickRate);
+    ~ArenaServer();
+
+    // port = 0: để hệ điều hành chọn cổng (xem getPort())
+    bool open(int port);
+    void close();
+
+    // Một bước: nhận gói, chạy ArenaSim, gửi snapshot
+    void tick();
+    // Chạy theo tickRate (0: nhanh nhất có thể) tới khi *stop
+    void run(const std::atomic<bool>* stop);
+
+    int getPort() const { return port; }
+    int getPlayerCount() const { return static_cast<int>(clients.size() - freeSlots.size()); }
+    const ArenaSim& getArena() const { return arena; }
+    // Chỉ đọc khi máy chủ không chạy ở luồng khác
+    const ArenaServerStats& getStats() const { return stats; }
+    void resetStats();
+    // Gọi được từ luồng khác: thống kê được xóa ở đầu bước sau
+    void requestStatsReset() { statsResetRequested = true; }
+};
+
+#endif // ARENASERVER_H
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArenaClient.h"
+#include "ArenaServer.h"
+
+// snake_server: máy chủ đấu trường nhiều người chơi qua UDP.
+//
+//   snake_server [--port 7777] [--cols 256] [--rows 256] [--players 64] [--foods N]
+//                [--tick-rate 20]
+//   snake_server --loadtest 100,250,500 [--seconds 5] [--tick-rate 20]
+//
+// --loadtest chạy máy chủ ở một luồng và N bot ở luồng khác, nói chuyện qua loopback.
+// Bàn chơi lớn theo số bot (CELLS_PER_PLAYER ô mỗi người) để mật độ giữ nguyên,
+// rồi in số bước/giây, thời gian xử lý mỗi bước và số byte mỗi người chơi nhận mỗi giây.
+
+#ifdef __linux__
+
+#include <poll.h>
+
+namespace {
+
+const int CELLS_PER_PLAYER = 400;
+const int FOODS_PER_PLAYER = 2;
+const int WARMUP_SECONDS = 1;
+
+std::atomic<bool> stopRequested(false);
+
+void onSignal(int) {
+    stopRequested = true;
+}
+
+struct Options {
+    int port;
+    int cols;
+    int rows;
+    int players;
+    int foods;
+    int tickRate;
+    std::vector<int> loadTest;
+    int seconds;
+    bool help;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Cách dùng: snake_server [--port 7777] [--cols 256] [--rows 256] [--players 64] [--foods N]\n"
+        << "                    [--tick-rate 20]\n"
+        << "           snake_server --loadtest 100,250,500 [--seconds 5] [--tick-rate 20]" << std::endl;
+}
+
+bool parseOptions(int argc, char* args[], Options& options) {
+    options.port = 7777;
+    options.cols = 256;
+    options.rows = 256;
+    options.players = 64;
+    options.foods = 0;
+    options.tickRate = 20;
+    options.seconds = 5;
+    options.help = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            options.help = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Thiếu giá trị cho " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = args[++i];
+        if (arg == "--port") {
+            options.port = atoi(value.c_str());
+        } else if (arg == "--cols") {
+            options.cols = atoi(value.c_str());
+        } else if (arg == "--rows") {
+            options.rows = atoi(value.c_str());
+        } else if (arg == "--players") {
+            options.players = atoi(value.c_str());
+        } else if (arg == "--foods") {
+            options.foods = atoi(value.c_str());
+        } else if (arg == "--tick-rate") {
+            options.tickRate = atoi(value.c_str());
+        } else if (arg == "--loadtest") {
+            std::stringstream stream(value);
+            std::string part;
+            while (std::getline(stream, part, ',')) {
+                if (atoi(part.c_str()) > 0) {
+                    options.loadTest.push_back(atoi(part.c_str()));
+                }
+            }
+        } else if (arg == "--seconds") {
+            options.seconds = atoi(value.c_str());
+        } else {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.foods <= 0) {
+        options.foods = options.players * FOODS_PER_PLAYER;
+    }
+    // Tọa độ trong gói tin là 16 bit; ArenaSim đánh chỉ số ô bằng int nên tích cũng có giới hạn
+    return options.cols >= 4 && options.rows >= 4 && options.cols <= 65535 && options.rows <= 65535 &&
+           static_cast<long long>(options.cols) * options.rows <= GameSim::MAX_CELLS &&
+           options.players > 0 && options.players <= 65535 && options.tickRate >= 0 && options.seconds > 0;
+}
+
+int serve(const Options& options) {
+    ArenaServer server(options.cols, options.rows, options.players, options.foods, options.tickRate);
+    if (!server.open(options.port)) {
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    std::cout << "snake_server: cổng " << server.getPort() << ", bàn " << options.cols << "x" << options.rows
+              << ", tối đa " << options.players << " người chơi, " << options.tickRate << " bước/s" << std::endl;
+
+    server.run(&stopRequested);
+
+    const ArenaServerStats& stats = server.getStats();
+    std::cout << "snake_server: dừng sau " << stats.ticks << " bước, "
+              << (stats.ticks > 0 ? stats.busyMicros / stats.ticks : 0) << " us/bước" << std::endl;
+    return 0;
+}
+
+// Bot kịch bản: đi về phía mồi gần nhất nhìn thấy, tránh tường và phần thân gần đầu của mình
+Direction decideBot(const ArenaClient& client, Direction current) {
+    const NetSnapshot& snapshot = client.getSnapshot();
+    const NetSnake* self = nullptr;
+    for (int i = 0; i < snapshot.snakeCount; i++) {
+        if (snapshot.snakes[i].id == snapshot.selfId) {
+            self = &snapshot.snakes[i];
+        }
+    }
+    if (self == nullptr) {
+        return current;
+    }
+
+    int bestDistance = -1;
+    int targetX = self->x;
+    int targetY = self->y;
+    for (int i = 0; i < snapshot.foodCount; i++) {
+        int x = static_cast<int>(snapshot.foods[i] >> 16);
+        int y = static_cast<int>(snapshot.foods[i] & 0xFFFF);
+        int distance = abs(x - self->x) + abs(y - self->y);
+        if (bestDistance < 0 || distance < bestDistance) {
+            bestDistance = distance;
+            targetX = x;
+            targetY = y;
+        }
+    }
+
+    Direction order[4];
+    bool horizontal = abs(targetX - self->x) >= abs(targetY - self->y);
+    order[0] = horizontal ? (targetX > self->x ? RIGHT : LEFT) : (targetY > self->y ? DOWN : UP);
+    order[1] = horizontal ? (targetY > self->y ? DOWN : UP) : (targetX > self->x ? RIGHT : LEFT);
+    order[2] = static_cast<Direction>(order[1] ^ 1);
+    order[3] = static_cast<Direction>(order[0] ^ 1);
+
+    for (Direction dir : order) {
+        int x = self->x + (dir == RIGHT) - (dir == LEFT);
+        int y = self->y + (dir == DOWN) - (dir == UP);
+        if (dir == (current ^ 1) || x < 0 || y < 0 || x >= client.getCols() || y >= client.getRows()) {
+            continue;
+        }
+
+        // Thân mình: đi ngược chuỗi hướng từ đầu
+        bool blocked = false;
+        int sx = self->x;
+        int sy = self->y;
+        for (int j = 0; j < self->length - 1 && !blocked; j++) {
+            Direction step = getNetDirection(*self, j);
+            sx += (step == RIGHT) - (step == LEFT);
+            sy += (step == DOWN) - (step == UP);
+            blocked = (sx == x && sy == y);
+        }
+        if (!blocked) {
+            return dir;
+        }
+    }
+    return current;
+}
+
+int loadTest(const Options& options, int players) {
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(players) * CELLS_PER_PLAYER)));
+    ArenaServer server(side, side, players, players * FOODS_PER_PLAYER, options.tickRate);
+    if (!server.open(0)) {
+        return 1;
+    }
+
+    std::atomic<bool> stop(false);
+    std::thread serverThread([&server, &stop]() { server.run(&stop); });
+
+    std::vector<std::unique_ptr<ArenaClient>> bots;
+    std::vector<pollfd> polls;
+    std::vector<Direction> directions(players, RIGHT);
+    for (int i = 0; i < players; i++) {
+        bots.push_back(std::unique_ptr<ArenaClient>(new ArenaClient()));
+        if (!bots.back()->open("127.0.0.1", server.getPort())) {
+            stop = true;
+            serverThread.join();
+            return 1;
+        }
+        polls.push_back(pollfd{bots.back()->getFd(), POLLIN, 0});
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point measureStart = start + std::chrono::seconds(WARMUP_SECONDS);
+    std::chrono::steady_clock::time_point end = measureStart + std::chrono::seconds(options.seconds);
+    std::chrono::steady_clock::time_point lastJoin = start - std::chrono::seconds(1);
+    bool measuring = false;
+    long long snapshotsAtStart = 0;
+    long long rejected = 0;
+
+    while (true) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now >= end) {
+            break;
+        }
+        if (!measuring && now >= measureStart) {
+            // Chỉ đo khi mọi bot đã vào và có snapshot đầu tiên
+            server.requestStatsReset();
+            for (const std::unique_ptr<ArenaClient>& bot : bots) {
+                snapshotsAtStart += bot->getSnapshotCount();
+            }
+            measuring = true;
+        }
+        if (now - lastJoin >= std::chrono::milliseconds(250)) {
+            for (const std::unique_ptr<ArenaClient>& bot : bots) {
+                if (!bot->isJoined()) {
+                    bot->join();
+                }
+            }
+            lastJoin = now;
+        }
+
+        if (poll(polls.data(), polls.size(), 10) <= 0) {
+            continue;
+        }
+        for (int i = 0; i < players; i++) {
+            if (!(polls[i].revents & POLLIN)) {
+                continue;
+            }
+            ArenaClient& bot = *bots[i];
+            if (bot.receive() && bot.hasSnapshot()) {
+                directions[i] = decideBot(bot, directions[i]);
+                bot.sendInput(directions[i]);
+            }
+        }
+    }
+
+    stop = true;
+    serverThread.join();
+
+    long long snapshots = -snapshotsAtStart;
+    int joined = 0;
+    for (const std::unique_ptr<ArenaClient>& bot : bots) {
+        snapshots += bot->getSnapshotCount();
+        rejected += bot->getRejectedCount();
+        joined += bot->isJoined() ? 1 : 0;
+        bot->leave();
+    }
+
+    const ArenaServerStats& stats = server.getStats();
+    double seconds = options.seconds;
+    double perTick = stats.ticks > 0 ? stats.busyMicros / stats.ticks : 0;
+    double perClient = stats.clientTicks > 0 ? stats.busyMicros / stats.clientTicks : 0;
+    double bytesPerClient = stats.clientTicks > 0 ? static_cast<double>(stats.bytesSent) / stats.clientTicks * stats.ticks / seconds : 0;
+    double fullShare = stats.snapshots > 0 ? 100.0 * stats.fullSnapshots / stats.snapshots : 0;
+
+    std::cout << "  " << players << " bot (" << joined << " đã vào), bàn " << side << "x" << side << ": "
+              << stats.ticks / seconds << " bước/s, " << perTick << " us/bước (tối đa " << stats.maxTickMicros << "), "
+              << perClient << " us/người/bước" << std::endl;
+    std::cout << "      " << bytesPerClient << " B/người/s, "
+              << (stats.snapshots > 0 ? static_cast<double>(stats.bytesSent) / stats.snapshots : 0) << " B/snapshot, "
+              << fullShare << "% đầy đủ, bot giải mã " << snapshots / seconds / std::max(1, joined) << " snapshot/s"
+              << " (" << rejected << " bị bỏ)" << std::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* args[]) {
+    Options options;
+    if (!parseOptions(argc, args, options)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(std::cout);
+        return 0;
+    }
+    if (options.loadTest.empty()) {
+        return serve(options);
+    }
+
+    std::cout << "snake_server loadtest: " << options.tickRate << " bước/s, " << options.seconds << " s mỗi lần" << std::endl;
+    for (int players : options.loadTest) {
+        if (loadTest(options, players) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cerr << "snake_server cần Linux (recvmmsg/sendmmsg)" << std::endl;
+    return 1;
+}
+
+#endif // __linux__
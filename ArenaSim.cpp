@@ -0,0 +1,295 @@
+#include "ArenaSim.h"
+#include <cstdlib>
+
+namespace {
+
+// Direction: UP = 0, DOWN = 1, LEFT = 2, RIGHT = 3, nên hướng ngược là d ^ 1
+Direction opposite(Direction dir) {
+    return static_cast<Direction>(dir ^ 1);
+}
+
+SnakeSegment advance(SnakeSegment segment, Direction dir) {
+    switch (dir) {
+        case UP:
+            segment.y--;
+            break;
+        case DOWN:
+            segment.y++;
+            break;
+        case LEFT:
+            segment.x--;
+            break;
+        case RIGHT:
+            segment.x++;
+            break;
+    }
+    return segment;
+}
+
+}
+
+ArenaSim::ArenaSim(int cols, int rows, int snakeCount, int foodCount)
+    : cols(cols), rows(rows), tick(0),
+      snakes(snakeCount), headAt(cols * rows, -1), foodAt(cols * rows, -1),
+      foods(foodCount), missingFoods(0), newHeads(snakeCount), dying(snakeCount) {
+    grid.resize(cols, rows);
+    for (ArenaSnake& snake : snakes) {
+        snake.body.reset(64);
+        snake.direction = RIGHT;
+        snake.alive = false;
+        snake.life = 0;
+        snake.enabled = true;
+    }
+}
+
+void ArenaSim::reset(unsigned int seed) {
+    random.seed(seed);
+    tick = 0;
+    grid.clear();
+    foodAt.assign(foodAt.size(), -1);
+
+    for (int i = 0; i < getSnakeCount(); i++) {
+        ArenaSnake& snake = snakes[i];
+        snake.body.clear();
+        snake.alive = false;
+        snake.score = 0;
+        snake.deathTick = 0;
+        snake.target = 0;
+        if (snake.enabled) {
+            spawnSnake(i);
+        }
+    }
+
+    missingFoods = 0;
+    for (int i = 0; i < getFoodCount(); i++) {
+        foods[i].x = -1;
+        spawnFood(i);
+    }
+}
+
+bool ArenaSim::isFree(int col, int row) const {
+    return grid.contains(col, row) && !grid.isOccupied(col, row);
+}
+
+bool ArenaSim::spawnSnake(int index) {
+    ArenaSnake& snake = snakes[index];
+
+    // Thử vài ô trống ngẫu nhiên; bàn quá đông thì để bước sau thử lại
+    for (int attempt = 0; attempt < 16 && grid.getFreeCount() > 0; attempt++) {
+        int cell = grid.getFreeCell(static_cast<int>(random.nextBelow(grid.getFreeCount())));
+        SnakeSegment head = {cell % cols, cell / cols};
+        Direction dir = static_cast<Direction>(random.nextBelow(4));
+
+        // Thân nằm sau đầu, và ô phía trước phải trống để không chết ngay
+        SnakeSegment ahead = advance(head, dir);
+        SnakeSegment second = advance(head, opposite(dir));
+        SnakeSegment third = advance(second, opposite(dir));
+        if (!isFree(ahead.x, ahead.y) || !isFree(second.x, second.y) || !isFree(third.x, third.y)) {
+            continue;
+        }
+
+        snake.body.clear();
+        snake.body.pushBack(head);
+        snake.body.pushBack(second);
+        snake.body.pushBack(third);
+        for (const SnakeSegment& segment : snake.body) {
+            grid.add(segment.x, segment.y);
+        }
+
+        snake.direction = dir;
+        snake.lastTail = third;
+        snake.alive = true;
+        snake.score = 0;
+        snake.life++;
+        snake.target = foods.empty() ? 0 : static_cast<int>(random.nextBelow(getFoodCount()));
+        return true;
+    }
+    return false;
+}
+
+void ArenaSim::removeSnake(int index) {
+    ArenaSnake& snake = snakes[index];
+    for (const SnakeSegment& segment : snake.body) {
+        grid.remove(segment.x, segment.y);
+    }
+    snake.body.clear();
+    snake.alive = false;
+    snake.deathTick = tick;
+}
+
+void ArenaSim::spawnFood(int index) {
+    for (int attempt = 0; attempt < 16 && grid.getFreeCount() > 0; attempt++) {
+        int cell = grid.getFreeCell(static_cast<int>(random.nextBelow(grid.getFreeCount())));
+        if (foodAt[cell] < 0) {
+            foodAt[cell] = index;
+            foods[index].x = cell % cols;
+            foods[index].y = cell / cols;
+            return;
+        }
+    }
+
+    // Chưa đặt được, thử lại ở bước sau
+    foods[index].x = -1;
+    missingFoods++;
+}
+
+void ArenaSim::step(const Direction* actions) {
+    tick++;
+    int count = getSnakeCount();
+
+    // Đổi hướng, tính đầu mới và cho mọi đuôi rời ô trước
+    for (int i = 0; i < count; i++) {
+        ArenaSnake& snake = snakes[i];
+        if (!snake.alive) {
+            continue;
+        }
+        if (actions[i] != opposite(snake.direction)) {
+            snake.direction = actions[i];
+        }
+        newHeads[i] = advance(snake.body.front(), snake.direction);
+        dying[i] = 0;
+
+        snake.lastTail = snake.body.back();
+        grid.remove(snake.lastTail.x, snake.lastTail.y);
+        snake.body.popBack();
+    }
+
+    // Va chạm: bảng chiếm chỗ lúc này chỉ còn phần thân, nên đầu vào ô bị chiếm là
+    // đâm vào thân (của mình hay của rắn khác). Đầu gặp đầu thì so độ dài.
+    for (int i = 0; i < count; i++) {
+        if (!snakes[i].alive) {
+            continue;
+        }
+        const SnakeSegment& head = newHeads[i];
+        if (!grid.contains(head.x, head.y) || grid.isOccupied(head.x, head.y)) {
+            dying[i] = 1;
+            continue;
+        }
+
+        int cell = head.y * cols + head.x;
+        int other = headAt[cell];
+        if (other < 0) {
+            headAt[cell] = i;
+            continue;
+        }
+
+        // Ô giữ rắn dài nhất đã tới; chỉ rắn dài hơn hẳn mọi đầu khác sống sót
+        size_t length = snakes[i].body.size();
+        size_t otherLength = snakes[other].body.size();
+        if (length > otherLength) {
+            dying[other] = 1;
+            headAt[cell] = i;
+        } else {
+            dying[i] = 1;
+            if (length == otherLength) {
+                dying[other] = 1;
+            }
+        }
+    }
+
+    // Áp dụng: rắn chết bị xóa khỏi bàn, rắn sống nhận đầu mới và ăn mồi
+    for (int i = 0; i < count; i++) {
+        ArenaSnake& snake = snakes[i];
+        if (!snake.alive) {
+            continue;
+        }
+        const SnakeSegment& head = newHeads[i];
+        if (grid.contains(head.x, head.y)) {
+            headAt[head.y * cols + head.x] = -1;
+        }
+        if (dying[i]) {
+            removeSnake(i);
+            continue;
+        }
+
+        snake.body.pushFront(head);
+        grid.add(head.x, head.y);
+
+        int cell = head.y * cols + head.x;
+        int food = foodAt[cell];
+        if (food >= 0) {
+            // Như Snake::grow(): nhân đôi đoạn đuôi
+            SnakeSegment tail = snake.body.back();
+            snake.body.pushBack(tail);
+            grid.add(tail.x, tail.y);
+            snake.score += GameSim::FOOD_SCORE;
+
+            foodAt[cell] = -1;
+            spawnFood(food);
+        }
+    }
+
+    // Hồi sinh và đặt lại mồi còn thiếu
+    for (int i = 0; i < count; i++) {
+        if (!snakes[i].alive && snakes[i].enabled && tick - snakes[i].deathTick >= RESPAWN_TICKS) {
+            spawnSnake(i);
+        }
+    }
+    if (missingFoods > 0) {
+        missingFoods = 0;
+        for (int i = 0; i < getFoodCount(); i++) {
+            if (foods[i].x < 0) {
+                spawnFood(i);
+            }
+        }
+    }
+}
+
+void ArenaSim::setEnabled(int index, bool enabled) {
+    ArenaSnake& snake = snakes[index];
+    if (snake.enabled == enabled) {
+        return;
+    }
+
+    snake.enabled = enabled;
+    if (!enabled && snake.alive) {
+        removeSnake(index);
+    } else if (enabled) {
+        snake.deathTick = tick - RESPAWN_TICKS;
+    }
+}
+
+Direction ArenaSim::decideBot(int index) {
+    const ArenaSnake& snake = snakes[index];
+    if (!snake.alive || foods.empty()) {
+        return snake.direction;
+    }
+
+    // Thỉnh thoảng đổi mục tiêu để các bot không cùng đuổi một mồi mãi
+    int target = snake.target;
+    if (foods[target].x < 0 || random.nextBelow(64) == 0) {
+        target = static_cast<int>(random.nextBelow(getFoodCount()));
+        snakes[index].target = target;
+    }
+
+    // Ưu tiên trục còn xa hơn, rồi trục kia, rồi hai hướng còn lại
+    SnakeSegment head = snake.body.front();
+    int dx = foods[target].x - head.x;
+    int dy = foods[target].y - head.y;
+    Direction horizontal = (dx > 0 || (dx == 0 && (random.next() & 1))) ? RIGHT : LEFT;
+    Direction vertical = (dy > 0 || (dy == 0 && (random.next() & 1))) ? DOWN : UP;
+
+    Direction order[4];
+    order[0] = abs(dx) >= abs(dy) ? horizontal : vertical;
+    order[1] = abs(dx) >= abs(dy) ? vertical : horizontal;
+    order[2] = opposite(order[1]);
+    order[3] = opposite(order[0]);
+
+    for (Direction dir : order) {
+        SnakeSegment next = advance(head, dir);
+        if (dir != opposite(snake.direction) && isFree(next.x, next.y)) {
+            return dir;
+        }
+    }
+    return snake.direction;
+}
+
+int ArenaSim::getAliveCount() const {
+    int alive = 0;
+    for (const ArenaSnake& snake : snakes) {
+        if (snake.alive) {
+            alive++;
+        }
+    }
+    return alive;
+}
@@ -0,0 +1,81 @@
+#ifndef ARENASIM_H
+#define ARENASIM_H
+
+#include <vector>
+#include <cstdint>
+
+#include "GameSim.h"
+#include "Random.h"
+
+// Một con rắn trong đấu trường. Tọa độ tính theo ô (không phải điểm ảnh).
+struct ArenaSnake {
+    SnakeBody body;
+    Direction direction;
+    SnakeSegment lastTail;  // Đoạn đuôi vừa bỏ ở bước gần nhất (để nội suy khi vẽ)
+    bool alive;
+    int score;
+    int deathTick;          // Bước chết gần nhất, để hồi sinh sau RESPAWN_TICKS
+    int target;             // Mồi mà bot đang nhắm tới
+    int life;               // Tăng mỗi lần hồi sinh, để phân biệt hai lượt sống của cùng một rắn
+    bool enabled;           // Rắn bị tắt thì không có trên bàn và không hồi sinh
+};
+
+// Đấu trường nhiều rắn trên một bàn chơi lớn, không phụ thuộc SDL.
+// Mọi rắn dùng chung một bảng chiếm chỗ (Grid), mồi có bảng tra theo ô, nên
+// va chạm đầu-thân, đầu-đầu và ăn mồi đều là tra cứu O(1) theo ô của đầu:
+// mỗi bước tốn O(số rắn), không phụ thuộc tổng số đoạn thân.
+//
+// Các rắn di chuyển đồng thời: mọi đuôi rời ô trước, rồi mọi đầu mới được xét
+// với phần thân còn lại. Hai đầu vào cùng một ô thì chỉ rắn dài hơn hẳn sống sót.
+// Rắn chết được xóa khỏi bàn và hồi sinh ở chỗ trống sau RESPAWN_TICKS bước.
+class ArenaSim {
+private:
+    int cols;
+    int rows;
+    int tick;
+
+    std::vector<ArenaSnake> snakes;
+    Grid grid;                  // Số đoạn thân trên mỗi ô, của mọi rắn
+    std::vector<int> headAt;    // Rắn có đầu vừa vào ô này trong bước hiện tại, -1 nếu không
+    std::vector<int> foodAt;    // Chỉ số mồi trên mỗi ô, -1 nếu không có
+    std::vector<Point> foods;   // x < 0: mồi chưa đặt được (bàn đầy)
+    int missingFoods;
+    std::vector<SnakeSegment> newHeads;
+    std::vector<unsigned char> dying;
+    Random random;
+
+    bool spawnSnake(int index);
+    void removeSnake(int index);
+    void spawnFood(int index);
+    bool isFree(int col, int row) const;
+
+public:
+    static const int INITIAL_LENGTH = 3;
+    static const int RESPAWN_TICKS = 20;
+
+    ArenaSim(int cols, int rows, int snakeCount, int foodCount);
+
+    void reset(unsigned int seed);
+    // actions[i] là hướng mới của rắn i (quay đầu ngược lại bị bỏ qua như Snake)
+    void step(const Direction* actions);
+
+    // Tắt/bật một rắn (ví dụ chỗ trống trên máy chủ). Rắn vừa bật xuất hiện ở bước sau.
+    void setEnabled(int index, bool enabled);
+
+    // Bot đơn giản, O(1) mỗi rắn: đi về phía mồi đã chọn, tránh các ô đang bị chiếm
+    Direction decideBot(int index);
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    int getTick() const { return tick; }
+    int getSnakeCount() const { return static_cast<int>(snakes.size()); }
+    int getAliveCount() const;
+    const ArenaSnake& getSnake(int index) const { return snakes[index]; }
+    const Grid& getGrid() const { return grid; }
+
+    int getFoodCount() const { return static_cast<int>(foods.size()); }
+    Point getFood(int index) const { return foods[index]; }
+    bool hasFood(int col, int row) const { return grid.contains(col, row) && foodAt[row * cols + col] >= 0; }
+};
+
+#endif // ARENASIM_H
@@ -0,0 +1,115 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <iostream>
+
+AssetLoader::AssetLoader(AssetPack* assets)
+    : assets(assets) {
+    SDL_AtomicSet(&nextJob, 0);
+    SDL_AtomicSet(&completed, 0);
+}
+
+AssetLoader::~AssetLoader() {
+    release();
+}
+
+int AssetLoader::addJob(JobType type, const char* name) {
+    Job job;
+    job.type = type;
+    job.name = name;
+    job.surface = nullptr;
+    job.sound = nullptr;
+    jobs.push_back(job);
+    return static_cast<int>(jobs.size()) - 1;
+}
+
+int AssetLoader::addImage(const char* name) {
+    return addJob(JOB_IMAGE, name);
+}
+
+int AssetLoader::addSound(const char* name) {
+    return addJob(JOB_SOUND, name);
+}
+
+void AssetLoader::start(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = SDL_GetCPUCount();
+    }
+    if (threadCount > getTotal()) {
+        threadCount = getTotal();
+    }
+
+    for (int i = 0; i < threadCount; i++) {
+        SDL_Thread* thread = SDL_CreateThread(workerMain, "AssetLoader", this);
+        if (!thread) {
+            std::cerr << "Không thể tạo luồng tải tài nguyên! SDL_Error: " << SDL_GetError() << std::endl;
+            break;
+        }
+        threads.push_back(thread);
+    }
+
+    // Không tạo được luồng nào thì tải ngay trên luồng này
+    if (threads.empty()) {
+        work();
+    }
+}
+
+int AssetLoader::workerMain(void* data) {
+    static_cast<AssetLoader*>(data)->work();
+    return 0;
+}
+
+void AssetLoader::work() {
+    // Mỗi luồng lần lượt nhận việc kế tiếp cho tới khi hết
+    int id;
+    while ((id = SDL_AtomicAdd(&nextJob, 1)) < getTotal()) {
+        PROFILE_SCOPE("decodeAsset");
+        Job& job = jobs[id];
+        if (job.type == JOB_IMAGE) {
+            job.surface = assets->loadSurface(job.name.c_str());
+            if (!job.surface) {
+                job.error = SDL_GetError();
+            }
+        } else {
+            job.sound = assets->loadSound(job.name.c_str());
+            if (!job.sound) {
+                job.error = Mix_GetError();
+            }
+        }
+        SDL_AtomicAdd(&completed, 1);
+    }
+}
+
+void AssetLoader::wait() {
+    for (SDL_Thread* thread : threads) {
+        SDL_WaitThread(thread, nullptr);
+    }
+    threads.clear();
+}
+
+void AssetLoader::release() {
+    wait();
+
+    // Giải phóng những kết quả chưa ai lấy
+    for (Job& job : jobs) {
+        if (job.surface) {
+            SDL_FreeSurface(job.surface);
+            job.surface = nullptr;
+        }
+        if (job.sound) {
+            Mix_FreeChunk(job.sound);
+            job.sound = nullptr;
+        }
+    }
+}
+
+SDL_Surface* AssetLoader::takeSurface(int id) {
+    SDL_Surface* surface = jobs[id].surface;
+    jobs[id].surface = nullptr;
+    return surface;
+}
+
+Mix_Chunk* AssetLoader::takeSound(int id) {
+    Mix_Chunk* sound = jobs[id].sound;
+    jobs[id].sound = nullptr;
+    return sound;
+}
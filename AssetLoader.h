@@ -0,0 +1,65 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+// Giải mã ảnh và âm thanh song song trên các luồng phụ. Luồng vẽ chỉ cần
+// lấy kết quả (take*) rồi tự tải lên GPU, vì renderer SDL không dùng được
+// từ luồng khác. Mọi việc phải được thêm trước start().
+class AssetLoader {
+private:
+    enum JobType {
+        JOB_IMAGE,
+        JOB_SOUND
+    };
+
+    struct Job {
+        JobType type;
+        std::string name;
+        SDL_Surface* surface;
+        Mix_Chunk* sound;
+        std::string error; // Lỗi SDL là riêng từng luồng nên phải chép lại
+    };
+
+    AssetPack* assets;
+    std::vector<Job> jobs;
+    std::vector<SDL_Thread*> threads;
+    SDL_atomic_t nextJob;
+    SDL_atomic_t completed;
+
+    static int workerMain(void* data);
+    void work();
+    int addJob(JobType type, const char* name);
+
+public:
+    explicit AssetLoader(AssetPack* assets);
+    ~AssetLoader();
+
+    // Trả về id dùng để lấy kết quả
+    int addImage(const char* name);
+    int addSound(const char* name);
+
+    // threadCount = 0: dùng tất cả lõi CPU (không quá số việc)
+    void start(int threadCount = 0);
+    // Chờ mọi việc xong và gom các luồng; gọi nhiều lần cũng được
+    void wait();
+    // wait() rồi giải phóng những kết quả chưa ai lấy; phải gọi trước Mix_Quit và SDL_Quit
+    void release();
+
+    int getCompleted() { return SDL_AtomicGet(&completed); }
+    int getTotal() const { return static_cast<int>(jobs.size()); }
+    bool isDone() { return getCompleted() == getTotal(); }
+
+    // Chỉ gọi sau wait(); người gọi nhận quyền sở hữu kết quả.
+    // Trả về nullptr nếu việc đó lỗi, khi đó getError() cho biết lý do.
+    SDL_Surface* takeSurface(int id);
+    Mix_Chunk* takeSound(int id);
+    const std::string& getError(int id) const { return jobs[id].error; }
+};
+
+#endif // ASSETLOADER_H
@@ -0,0 +1,205 @@
+#include "AssetPack.h"
+#include <SDL_image.h>
+#include <iostream>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::AssetPack()
+    : data(nullptr), dataSize(0),
+#ifdef _WIN32
+      fileHandle(nullptr), mappingHandle(nullptr),
+#endif
+      entries(nullptr), entryCount(0), mutex(SDL_CreateMutex()) {
+}
+
+AssetPack::~AssetPack() {
+    close();
+    SDL_DestroyMutex(mutex);
+}
+
+bool AssetPack::open(const char* path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const Uint8*>(view);
+    dataSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Vùng ánh xạ vẫn giữ tệp mở
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    data = static_cast<const Uint8*>(view);
+    dataSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Kiểm tra đầu tệp và bảng mục lục trước khi tin vào các offset
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(data);
+    if (dataSize < sizeof(PackHeader) ||
+        memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 ||
+        header->version != PACK_VERSION ||
+        header->entryCount > (dataSize - sizeof(PackHeader)) / sizeof(PackEntry)) {
+        std::cerr << "Gói tài nguyên " << path << " không hợp lệ!" << std::endl;
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const PackEntry*>(data + sizeof(PackHeader));
+    entryCount = header->entryCount;
+    for (Uint32 i = 0; i < entryCount; i++) {
+        if (entries[i].offset > dataSize || entries[i].size > dataSize - entries[i].offset) {
+            std::cerr << "Gói tài nguyên " << path << " bị cắt cụt!" << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AssetPack::close() {
+    for (Uint8* buffer : convertedSounds) {
+        SDL_free(buffer);
+    }
+    convertedSounds.clear();
+
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<Uint8*>(data), dataSize);
+#endif
+    }
+
+    data = nullptr;
+    dataSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const PackEntry* AssetPack::find(const char* name, Uint32 type) const {
+    for (Uint32 i = 0; i < entryCount; i++) {
+        if (entries[i].type == type && strncmp(entries[i].name, name, PACK_NAME_LENGTH) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+SDL_Surface* AssetPack::loadSurface(const char* name) {
+    const PackEntry* entry = find(name, PACK_IMAGE);
+    if (!entry) {
+        return IMG_Load((std::string("assets/") + name).c_str());
+    }
+
+    if (static_cast<Sint64>(entry->pitch) * entry->height > static_cast<Sint64>(entry->size)) {
+        SDL_SetError("Ảnh %s trong gói bị hỏng", name);
+        return nullptr;
+    }
+
+    // Bề mặt trỏ thẳng vào vùng ánh xạ; SDL chỉ đọc khi chép hoặc chuyển định dạng
+    return SDL_CreateRGBSurfaceWithFormatFrom(const_cast<Uint8*>(data + entry->offset),
+                                              entry->width, entry->height, 32,
+                                              entry->pitch, entry->format);
+}
+
+Mix_Chunk* AssetPack::loadSound(const char* name) {
+    const PackEntry* entry = find(name, PACK_SOUND);
+    if (!entry) {
+        return Mix_LoadWAV((std::string("assets/") + name).c_str());
+    }
+
+    Uint8* samples = const_cast<Uint8*>(data + entry->offset);
+    Uint32 length = entry->size;
+
+    // Bộ trộn có thể mở với định dạng khác yêu cầu; khi đó mới phải chuyển đổi
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    Mix_QuerySpec(&frequency, &format, &channels);
+    if (frequency != entry->width || format != entry->format || channels != entry->height) {
+        SDL_AudioCVT cvt;
+        if (SDL_BuildAudioCVT(&cvt, static_cast<Uint16>(entry->format), static_cast<Uint8>(entry->height), entry->width,
+                              format, static_cast<Uint8>(channels), frequency) < 0) {
+            return nullptr;
+        }
+
+        cvt.len = static_cast<int>(length);
+        cvt.buf = static_cast<Uint8*>(SDL_malloc(length * cvt.len_mult));
+        if (!cvt.buf) {
+            return nullptr;
+        }
+        memcpy(cvt.buf, samples, length);
+        if (SDL_ConvertAudio(&cvt) < 0) {
+            SDL_free(cvt.buf);
+            return nullptr;
+        }
+
+        SDL_LockMutex(mutex);
+        convertedSounds.push_back(cvt.buf);
+        SDL_UnlockMutex(mutex);
+        samples = cvt.buf;
+        length = static_cast<Uint32>(cvt.len_cvt);
+    }
+
+    // Mix_QuickLoad_RAW không chép và không giải phóng bộ nhớ mẫu
+    return Mix_QuickLoad_RAW(samples, length);
+}
+
+SDL_RWops* AssetPack::openFile(const char* name) {
+    const PackEntry* entry = find(name, PACK_RAW);
+    if (!entry) {
+        return SDL_RWFromFile((std::string("assets/") + name).c_str(), "rb");
+    }
+    return SDL_RWFromConstMem(data + entry->offset, static_cast<int>(entry->size));
+}
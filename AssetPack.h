@@ -0,0 +1,84 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <vector>
+
+// Định dạng gói tài nguyên (assets.pak), ghi bởi snake_pack:
+//   PackHeader | PackEntry[entryCount] | dữ liệu (mỗi mục căn lề PACK_ALIGNMENT byte)
+// Ảnh đã giải mã sẵn sang PACK_PIXEL_FORMAT, âm thanh đã chuyển sẵn sang định dạng
+// mà Game mở bộ trộn, nên lúc chạy chỉ cần ánh xạ tệp vào bộ nhớ, không giải mã.
+// Các số được ghi theo thứ tự byte của máy đóng gói (little-endian trên x86/ARM).
+static const char PACK_MAGIC[8] = {'S', 'N', 'A', 'K', 'P', 'A', 'K', '1'};
+static const Uint32 PACK_VERSION = 1;
+static const Uint32 PACK_ALIGNMENT = 16;
+static const int PACK_NAME_LENGTH = 32;
+
+// Định dạng điểm ảnh của atlas trong SpriteBatch
+static const Uint32 PACK_PIXEL_FORMAT = SDL_PIXELFORMAT_RGBA32;
+// Định dạng đầu ra của bộ trộn mà Game::init() yêu cầu
+static const int PACK_AUDIO_FREQUENCY = 44100;
+static const Uint16 PACK_AUDIO_FORMAT = AUDIO_S16SYS;
+static const int PACK_AUDIO_CHANNELS = 2;
+
+enum PackEntryType {
+    PACK_RAW,    // Dữ liệu nguyên gốc (font)
+    PACK_IMAGE,  // Điểm ảnh đã giải mã
+    PACK_SOUND   // PCM đã chuyển định dạng
+};
+
+struct PackHeader {
+    char magic[8];
+    Uint32 version;
+    Uint32 entryCount;
+};
+
+struct PackEntry {
+    char name[PACK_NAME_LENGTH];  // Tên tệp gốc, ví dụ "food.png"
+    Uint32 type;
+    Uint32 offset;                // Tính từ đầu tệp
+    Uint32 size;
+    Uint32 format;                // Định dạng điểm ảnh hoặc định dạng âm thanh
+    Sint32 width;                 // Ảnh: kích thước; âm thanh: tần số và số kênh
+    Sint32 height;
+    Sint32 pitch;
+    Sint32 reserved;
+};
+
+// Nguồn tài nguyên của game. Nếu mở được gói thì mọi thứ được đọc thẳng từ
+// vùng nhớ ánh xạ; nếu không thì đọc các tệp rời trong assets/ như trước.
+// Sau open(), các hàm load*/openFile có thể gọi đồng thời từ nhiều luồng.
+class AssetPack {
+private:
+    const Uint8* data;   // Vùng ánh xạ của cả tệp gói
+    size_t dataSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+    const PackEntry* entries;
+    Uint32 entryCount;
+    std::vector<Uint8*> convertedSounds; // Âm thanh phải chuyển lại khi bộ trộn khác định dạng
+    SDL_mutex* mutex;                    // Bảo vệ convertedSounds khi tải từ nhiều luồng
+
+    const PackEntry* find(const char* name, Uint32 type) const;
+
+public:
+    AssetPack();
+    ~AssetPack();
+
+    // Ánh xạ tệp gói vào bộ nhớ; trả về false nếu không có gói hoặc gói hỏng
+    bool open(const char* path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    // Ảnh trả về dùng chung bộ nhớ với gói, người gọi giải phóng bằng SDL_FreeSurface
+    SDL_Surface* loadSurface(const char* name);
+    // Âm thanh giải phóng bằng Mix_FreeChunk trước khi đóng gói
+    Mix_Chunk* loadSound(const char* name);
+    // Luồng đọc tệp nguyên gốc (font), giải phóng bằng SDL_RWclose
+    SDL_RWops* openFile(const char* name);
+};
+
+#endif // ASSETPACK_H
@@ -0,0 +1,337 @@
+#include "Autopilot.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const Direction ALL_DIRECTIONS[] = {UP, DOWN, LEFT, RIGHT};
+
+// Chu trình Hamilton trên bàn có số hàng chẵn: hàng 0 sang phải, các hàng sau
+// chạy zigzag trên cột 1..cols-1, rồi về theo cột 0
+Direction rowCycle(int x, int y, int cols, int rows) {
+    if (x == 0) {
+        return y == 0 ? RIGHT : UP;
+    }
+    if (y % 2 == 0) {
+        return x < cols - 1 ? RIGHT : DOWN;
+    }
+    if (x > 1) {
+        return LEFT;
+    }
+    return y == rows - 1 ? LEFT : DOWN;
+}
+
+// Đổi hướng khi lật bàn qua đường chéo (dùng cho bàn có số cột chẵn)
+Direction transpose(Direction dir) {
+    switch (dir) {
+        case UP:
+            return LEFT;
+        case DOWN:
+            return RIGHT;
+        case LEFT:
+            return UP;
+        case RIGHT:
+            return DOWN;
+    }
+    return dir;
+}
+
+}
+
+const uint32_t Autopilot::WALL;
+
+Autopilot::Autopilot()
+    : cols(0), rows(0), stride(0), gridSize(0), hasCycle(false), seenStamp(0), blockStamp(0),
+      latencies(LATENCY_HISTORY), sorted(LATENCY_HISTORY),
+      decisions(0), totalMicros(0), maxMicros(0) {
+}
+
+void Autopilot::resize(int cols, int rows, int gridSize) {
+    if (cols == this->cols && rows == this->rows && gridSize == this->gridSize) {
+        return;
+    }
+
+    // Chỉ cấp phát khi đổi kích thước bàn chơi
+    this->cols = cols;
+    this->rows = rows;
+    this->gridSize = gridSize;
+    stride = cols + 2;
+    int cells = stride * (rows + 2);
+    seen.assign(cells, 0);
+    blocked.assign(cells, WALL);
+    parent.assign(cells, -1);
+    queue.assign(cells, 0);
+    cycle.assign(cells, 0);
+    cycleIndex.assign(cells, 0);
+    seenStamp = 0;
+    blockStamp = 0;
+    clearBlocked();
+    buildCycle();
+}
+
+void Autopilot::buildCycle() {
+    hasCycle = (rows % 2 == 0 && cols >= 2) || (cols % 2 == 0 && rows >= 2);
+    if (!hasCycle) {
+        return;
+    }
+
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            Direction dir = (rows % 2 == 0) ? rowCycle(x, y, cols, rows) : transpose(rowCycle(y, x, rows, cols));
+            cycle[(y + 1) * stride + x + 1] = static_cast<unsigned char>(dir);
+        }
+    }
+
+    // Đánh số các ô theo thứ tự đi trên chu trình, bắt đầu từ góc trên trái
+    int cell = stride + 1;
+    for (int i = 0; i < cols * rows; i++) {
+        cycleIndex[cell] = i;
+        cell += offset(static_cast<Direction>(cycle[cell]));
+    }
+}
+
+int Autopilot::cycleDistance(int from, int to) const {
+    int distance = cycleIndex[to] - cycleIndex[from];
+    return distance < 0 ? distance + cols * rows : distance;
+}
+
+bool Autopilot::isFree(const Grid& grid, int cell, int tail, bool tailMoves) const {
+    return blocked[cell] != WALL && (countAt(grid, cell) == 0 || (cell == tail && tailMoves));
+}
+
+void Autopilot::clearBlocked() {
+    for (int y = 0; y < rows; y++) {
+        std::fill(&blocked[(y + 1) * stride + 1], &blocked[(y + 1) * stride + 1] + cols, 0);
+    }
+}
+
+// Tăng thế hệ thay cho xóa mảng; chỉ xóa thật khi bộ đếm sắp quay vòng
+void Autopilot::nextSeen() {
+    if (++seenStamp == WALL) {
+        std::fill(seen.begin(), seen.end(), 0);
+        seenStamp = 1;
+    }
+}
+
+void Autopilot::nextBlocked() {
+    if (++blockStamp == WALL) {
+        clearBlocked();
+        blockStamp = 1;
+    }
+}
+
+int Autopilot::offset(Direction dir) const {
+    switch (dir) {
+        case UP:
+            return -stride;
+        case DOWN:
+            return stride;
+        case LEFT:
+            return -1;
+        case RIGHT:
+            return 1;
+    }
+    return 0;
+}
+
+int Autopilot::search(int start, int goal) {
+    // BFS qua các ô không bị chặn (ô đích luôn được vào), trả về số bước hoặc -1
+    nextSeen();
+    const int offsets[4] = {-stride, stride, -1, 1};
+    int front = 0;
+    int back = 0;
+    queue[back++] = start;
+    seen[start] = seenStamp;
+    parent[start] = -1;
+
+    bool found = (start == goal);
+    while (!found && front < back) {
+        int cell = queue[front++];
+        for (int i = 0; i < 4; i++) {
+            int next = cell + offsets[i];
+            if (seen[next] == seenStamp || (next != goal && blocked[next] >= blockStamp)) {
+                continue;
+            }
+            seen[next] = seenStamp;
+            parent[next] = cell;
+            if (next == goal) {
+                found = true;
+                break;
+            }
+            queue[back++] = next;
+        }
+    }
+
+    if (!found) {
+        return -1;
+    }
+    int steps = 0;
+    for (int cell = goal; cell != start; cell = parent[cell]) {
+        steps++;
+    }
+    return steps;
+}
+
+void Autopilot::blockBody(const SnakeBody& body, bool tailMoves) {
+    nextBlocked();
+    size_t count = tailMoves ? body.size() - 1 : body.size();
+    for (size_t i = 0; i < count; i++) {
+        blocked[cellOf(body[i])] = blockStamp;
+    }
+}
+
+bool Autopilot::canReachTail(const SnakeBody& body, int target, int steps, bool eats) {
+    // Thân rắn sau khi đi hết đường (theo parent từ target ngược về đầu): các ô
+    // của đường đi rồi tới phần đầu của thân cũ. Từ target phải còn đường tới đuôi mới.
+    size_t length = body.size() + (eats ? 1 : 0);
+    nextBlocked();
+
+    size_t count = 0;
+    int tail = target;
+    int cell = target;
+    while (count < length && count < static_cast<size_t>(steps)) {
+        blocked[cell] = blockStamp;
+        tail = cell;
+        cell = parent[cell];
+        count++;
+    }
+    for (size_t i = 0; count < length; i++, count++) {
+        tail = cellOf(body[i]);
+        blocked[tail] = blockStamp;
+    }
+
+    return tail == target || search(target, tail) > 0;
+}
+
+Direction Autopilot::choose(const GameSim& sim) {
+    resize(sim.getWorldWidth() / sim.getGridSize(), sim.getWorldHeight() / sim.getGridSize(), sim.getGridSize());
+
+    const Snake& snake = sim.getSnake();
+    const SnakeBody& body = snake.getSegments();
+    const Grid& grid = snake.getGrid();
+    Direction current = sim.getDirection();
+
+    int head = cellOf(body.front());
+    Point foodPosition = sim.getFood().getPosition();
+    int food = cellOf(SnakeSegment{foodPosition.x, foodPosition.y});
+
+    // Vừa ăn xong thì đoạn đuôi đang nhân đôi và bước sau không rời ô
+    int tail = cellOf(body.back());
+    bool tailMoves = countAt(grid, tail) == 1;
+
+    // Theo chu trình: ô kế tiếp phải nằm trước đuôi và không vượt quá mồi. Mỗi lần
+    // đi tắt để lại các ô trống sau đầu, chỉ trống lại phía trước khi đuôi đi qua; nên
+    // chỉ đi tắt khi đoạn trống còn lại phía trước vẫn dài ít nhất bằng thân rắn, nếu
+    // không thì có thể phải ăn ô trống cuối cùng ngay trước đuôi (đuôi đứng yên một
+    // bước sau khi ăn) trong khi chỗ trống còn lại đều nằm sau lưng.
+    int foodDistance = hasCycle ? cycleDistance(head, food) : 0;
+    int tailDistance = hasCycle ? cycleDistance(head, tail) : 0;
+    int maxJump = std::max(1, tailDistance - 1 - static_cast<int>(body.size()));
+
+    // Đường ngắn nhất tới mồi, chỉ đi nếu ăn xong vẫn không tự nhốt mình
+    blockBody(body, tailMoves);
+    int steps = search(head, food);
+    if (steps > 0) {
+        int first = food;
+        while (parent[first] != head) {
+            first = parent[first];
+        }
+        Direction dir = first == head - stride ? UP : first == head + stride ? DOWN : first == head - 1 ? LEFT : RIGHT;
+        int jump = hasCycle ? cycleDistance(head, first) : 0;
+        bool ordered = !hasCycle || (jump > 0 && jump <= foodDistance && jump <= maxJump && jump < tailDistance);
+        if (ordered && canReachTail(body, food, steps, true)) {
+            return dir;
+        }
+    }
+
+    // Đi tắt xa nhất mà vẫn giữ thứ tự của chu trình; bước đúng theo chu trình
+    // (jump = 1) luôn thỏa nếu thân rắn đang nằm theo chu trình
+    if (hasCycle) {
+        int bestJump = 0;
+        Direction best = current;
+        for (Direction dir : ALL_DIRECTIONS) {
+            int next = head + offset(dir);
+            if (!isFree(grid, next, tail, tailMoves)) {
+                continue;
+            }
+            int jump = cycleDistance(head, next);
+            if (jump > bestJump && jump <= foodDistance && jump <= maxJump && jump < tailDistance) {
+                bestJump = jump;
+                best = dir;
+            }
+        }
+        if (bestJump > 0) {
+            int next = head + offset(best);
+            parent[next] = head;
+            if (canReachTail(body, next, 1, next == food)) {
+                return best;
+            }
+        }
+    }
+
+    // Không thì đi một bước an toàn mà vẫn tới được đuôi: ưu tiên hướng của
+    // chu trình Hamilton, rồi đi thẳng, rồi các hướng còn lại
+    Direction order[6];
+    int orderCount = 0;
+    if (hasCycle) {
+        order[orderCount++] = static_cast<Direction>(cycle[head]);
+    }
+    order[orderCount++] = current;
+    for (Direction dir : ALL_DIRECTIONS) {
+        order[orderCount++] = dir;
+    }
+
+    Direction fallback = current;
+    bool hasFallback = false;
+    for (int i = 0; i < orderCount; i++) {
+        Direction dir = order[i];
+        int next = head + offset(dir);
+        if (!isFree(grid, next, tail, tailMoves)) {
+            continue;
+        }
+        if (!hasFallback) {
+            fallback = dir;
+            hasFallback = true;
+        }
+
+        parent[next] = head;
+        if (canReachTail(body, next, 1, next == food)) {
+            return dir;
+        }
+    }
+
+    // Không còn nước nào giữ được đường tới đuôi: ít nhất không chết ngay
+    return fallback;
+}
+
+Direction Autopilot::decide(const GameSim& sim) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Direction dir = choose(sim);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    latencies[decisions % LATENCY_HISTORY] = micros;
+    decisions++;
+    totalMicros += micros;
+    if (micros > maxMicros) {
+        maxMicros = micros;
+    }
+    return dir;
+}
+
+double Autopilot::getPercentileMicros(double p) const {
+    int count = static_cast<int>(std::min<long long>(decisions, LATENCY_HISTORY));
+    if (count == 0) {
+        return 0;
+    }
+
+    std::copy(latencies.begin(), latencies.begin() + count, sorted.begin());
+    int index = static_cast<int>(p * (count - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.begin() + count);
+    return sorted[index];
+}
+
+void Autopilot::resetStats() {
+    decisions = 0;
+    totalMicros = 0;
+    maxMicros = 0;
+}
@@ -0,0 +1,83 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "GameSim.h"
+
+// Lái tự động: tìm đường ngắn nhất tới mồi bằng BFS, chỉ đi theo đường đó nếu
+// sau khi ăn xong đầu rắn vẫn tới được đuôi (không tự nhốt mình).
+//
+// Khi bàn có chu trình Hamilton, mỗi bước còn phải giữ thứ tự của chu trình: ô kế
+// tiếp phải nằm trên đoạn trống từ đầu tới đuôi và không vượt quá mồi. Thân rắn khi
+// đó luôn nằm liền theo chu trình sau đầu, nên đi tắt không bao giờ tự nhốt mình và
+// khoảng cách theo chu trình tới mồi giảm sau mỗi bước: rắn chắc chắn ăn được mồi và
+// lấp kín bàn. Đường BFS không giữ thứ tự thì đi tắt xa nhất có thể, ít nhất là đi
+// đúng theo chu trình. Chỉ khi thân không nằm theo chu trình (người chơi vừa giao lái)
+// mới đi một bước an toàn bất kỳ, rồi đến đuổi theo đuôi.
+//
+// Mọi bộ đệm tìm kiếm (đánh dấu đã thăm, ô bị chặn, cha, hàng đợi) được cấp phát
+// một lần theo kích thước bàn và dùng lại ở mỗi bước; đánh dấu bằng số thế hệ
+// nên không phải xóa. Mỗi quyết định không cấp phát bộ nhớ.
+//
+// Các bảng có thêm một viền ô tường quanh bàn (chỉ số ô = (y + 1) * stride + x + 1)
+// để BFS tìm ô bên cạnh bằng phép cộng, không cần kiểm tra biên hay phép chia.
+class Autopilot {
+private:
+    static const int LATENCY_HISTORY = 4096;
+    static const uint32_t WALL = 0xFFFFFFFF;
+
+    int cols;
+    int rows;
+    int stride;     // cols + 2
+    int gridSize;
+
+    std::vector<uint32_t> seen;     // seen[cell] == seenStamp: đã thăm trong lần BFS hiện tại
+    std::vector<uint32_t> blocked;  // blocked[cell] >= blockStamp: ô bị chặn (viền luôn là WALL)
+    std::vector<int> parent;
+    std::vector<int> queue;
+    std::vector<unsigned char> cycle; // Hướng đi của chu trình Hamilton tại mỗi ô
+    std::vector<int> cycleIndex;      // Vị trí của mỗi ô trên chu trình, 0..cols * rows - 1
+    bool hasCycle;                    // Bàn có cả số hàng lẫn số cột lẻ thì không có chu trình
+    uint32_t seenStamp;
+    uint32_t blockStamp;
+
+    // Thời gian của các quyết định gần nhất (micro giây)
+    std::vector<double> latencies;
+    mutable std::vector<double> sorted;
+    long long decisions;
+    double totalMicros;
+    double maxMicros;
+
+    void resize(int cols, int rows, int gridSize);
+    void buildCycle();
+    void clearBlocked();
+    void nextSeen();
+    void nextBlocked();
+    int cellOf(const SnakeSegment& segment) const { return (segment.y / gridSize + 1) * stride + segment.x / gridSize + 1; }
+    int offset(Direction dir) const;
+    int countAt(const Grid& grid, int cell) const { return grid.count(cell % stride - 1, cell / stride - 1); }
+    // Số bước đi theo chu trình từ ô from tới ô to
+    int cycleDistance(int from, int to) const;
+    bool isFree(const Grid& grid, int cell, int tail, bool tailMoves) const;
+    int search(int start, int goal);
+    void blockBody(const SnakeBody& body, bool tailMoves);
+    bool canReachTail(const SnakeBody& body, int target, int steps, bool eats);
+    Direction choose(const GameSim& sim);
+
+public:
+    Autopilot();
+
+    // Hướng đi cho bước kế tiếp của sim
+    Direction decide(const GameSim& sim);
+
+    // Thống kê thời gian mỗi quyết định
+    long long getDecisionCount() const { return decisions; }
+    double getMeanMicros() const { return decisions > 0 ? totalMicros / decisions : 0; }
+    double getMaxMicros() const { return maxMicros; }
+    double getPercentileMicros(double p) const; // Trên LATENCY_HISTORY quyết định gần nhất
+    void resetStats();
+};
+
+#endif // AUTOPILOT_H
@@ -0,0 +1,276 @@
+#include "BatchSim.h"
+#include <cstring>
+#include <iostream>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+BatchSim::BatchSim(int count, int cols, int rows)
+    : count(isValidSize(cols, rows) ? count : 0),
+      cols(isValidSize(cols, rows) ? cols : 0), rows(isValidSize(cols, rows) ? rows : 0),
+      cells(this->cols * this->rows), capacity(cells + 1), bitWords((cells + 63) / 64),
+      headX(this->count), headY(this->count), direction(this->count), foodX(this->count), foodY(this->count),
+      length(this->count), ringHead(this->count), score(this->count), ticks(this->count), freeCount(this->count),
+      random(this->count), hitWall(this->count), hitFood(this->count),
+      results(this->count), episodeScore(this->count), episodeTicks(this->count),
+      body(static_cast<size_t>(this->count) * capacity),
+      occupied(static_cast<size_t>(this->count) * bitWords),
+      freeCells(static_cast<size_t>(this->count) * cells),
+      slotOf(static_cast<size_t>(this->count) * cells),
+      startOccupied(bitWords), startFreeCells(cells), startSlotOf(cells) {
+    // Chỉ số ô lưu bằng uint16_t: bàn lớn hơn sẽ bị cắt chỉ số và hỏng trạng thái,
+    // nên bị từ chối và BatchSim không có ván nào (getCount() == 0)
+    if (!isValidSize(cols, rows)) {
+        std::cerr << "BatchSim: bàn chơi " << cols << "x" << rows << " không hợp lệ (cần ít nhất 4 cột và tối đa "
+                  << MAX_CELLS << " ô)" << std::endl;
+        return;
+    }
+
+    // Dựng sẵn bitset và danh sách ô trống sau khi đặt rắn ban đầu (như Snake::init()),
+    // theo đúng thứ tự hoán đổi của Grid.
+    for (int c = 0; c < cells; c++) {
+        startFreeCells[c] = c;
+        startSlotOf[c] = c;
+    }
+
+    int freeSize = cells;
+    for (int i = 0; i < 3; i++) {
+        int cell = (rows / 2) * cols + (cols / 2 - i);
+        startOccupied[cell >> 6] |= uint64_t(1) << (cell & 63);
+
+        int slot = startSlotOf[cell];
+        int last = startFreeCells[--freeSize];
+        startFreeCells[slot] = last;
+        startSlotOf[last] = slot;
+    }
+}
+
+bool BatchSim::isValidSize(int cols, int rows) {
+    // Rắn ban đầu nằm ngang ở giữa bàn, cần 3 ô và một ô phía trước
+    return cols >= 4 && rows >= 1 && static_cast<long long>(cols) * rows <= MAX_CELLS;
+}
+
+void BatchSim::reset(unsigned int seed) {
+    for (int i = 0; i < count; i++) {
+        random[i].seed(seed + i);
+        resetEnv(i);
+    }
+}
+
+// Các thao tác trên danh sách ô trống giữ đúng thứ tự của Grid, nhờ đó
+// mồi xuất hiện ở cùng vị trí như trong GameSim
+void BatchSim::occupy(int env, int cell) {
+    occupied[env * bitWords + (cell >> 6)] |= uint64_t(1) << (cell & 63);
+
+    uint16_t* list = &freeCells[static_cast<size_t>(env) * cells];
+    uint16_t* slots = &slotOf[static_cast<size_t>(env) * cells];
+    int slot = slots[cell];
+    int last = list[--freeCount[env]];
+    list[slot] = last;
+    slots[last] = slot;
+}
+
+void BatchSim::release(int env, int cell) {
+    occupied[env * bitWords + (cell >> 6)] &= ~(uint64_t(1) << (cell & 63));
+
+    uint16_t* list = &freeCells[static_cast<size_t>(env) * cells];
+    slotOf[static_cast<size_t>(env) * cells + cell] = freeCount[env];
+    list[freeCount[env]++] = cell;
+}
+
+bool BatchSim::spawnFood(int env) {
+    if (freeCount[env] == 0) {
+        return false;
+    }
+
+    // Cùng cách chọn với Food::generate()
+    int cell = freeCells[static_cast<size_t>(env) * cells + random[env].nextBelow(freeCount[env])];
+
+    foodX[env] = cell % cols;
+    foodY[env] = cell / cols;
+    return true;
+}
+
+void BatchSim::resetEnv(int env) {
+    memcpy(&occupied[static_cast<size_t>(env) * bitWords], startOccupied.data(), bitWords * sizeof(uint64_t));
+    memcpy(&freeCells[static_cast<size_t>(env) * cells], startFreeCells.data(), cells * sizeof(uint16_t));
+    memcpy(&slotOf[static_cast<size_t>(env) * cells], startSlotOf.data(), cells * sizeof(uint16_t));
+    freeCount[env] = cells - 3;
+
+    // Rắn ban đầu 3 đoạn ở giữa bàn chơi, hướng sang phải (như Snake::init())
+    uint16_t* ring = &body[static_cast<size_t>(env) * capacity];
+    int startX = cols / 2;
+    int startY = rows / 2;
+    for (int i = 0; i < 3; i++) {
+        ring[i] = startY * cols + (startX - i);
+    }
+
+    headX[env] = startX;
+    headY[env] = startY;
+    direction[env] = RIGHT;
+    ringHead[env] = 0;
+    length[env] = 3;
+    score[env] = 0;
+    ticks[env] = 0;
+
+    spawnFood(env);
+}
+
+void BatchSim::moveHeads(const Direction* actions) {
+    // Đổi hướng (cấm quay đầu ngược lại), tính đầu mới, kiểm tra tường và mồi.
+    // Direction: UP = 0, DOWN = 1, LEFT = 2, RIGHT = 3, nên hướng ngược là d ^ 1.
+    const int32_t* action = reinterpret_cast<const int32_t*>(actions);
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i up = _mm256_set1_epi32(UP);
+    const __m256i down = _mm256_set1_epi32(DOWN);
+    const __m256i left = _mm256_set1_epi32(LEFT);
+    const __m256i right = _mm256_set1_epi32(RIGHT);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lastX = _mm256_set1_epi32(cols - 1);
+    const __m256i lastY = _mm256_set1_epi32(rows - 1);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(action + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&direction[i]));
+        __m256i reverse = _mm256_cmpeq_epi32(a, _mm256_xor_si256(d, one));
+        d = _mm256_blendv_epi8(a, d, reverse);
+
+        // cmpeq trả về -1 khi đúng
+        __m256i dx = _mm256_sub_epi32(_mm256_cmpeq_epi32(d, left), _mm256_cmpeq_epi32(d, right));
+        __m256i dy = _mm256_sub_epi32(_mm256_cmpeq_epi32(d, up), _mm256_cmpeq_epi32(d, down));
+        __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headX[i])), dx);
+        __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headY[i])), dy);
+
+        __m256i wall = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero, x), _mm256_cmpgt_epi32(x, lastX)),
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero, y), _mm256_cmpgt_epi32(y, lastY)));
+        __m256i food = _mm256_and_si256(
+            _mm256_cmpeq_epi32(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&foodX[i]))),
+            _mm256_cmpeq_epi32(y, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&foodY[i]))));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&direction[i]), d);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&headX[i]), x);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&headY[i]), y);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&hitWall[i]), wall);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&hitFood[i]), _mm256_andnot_si256(wall, food));
+    }
+#elif defined(__SSE2__)
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i up = _mm_set1_epi32(UP);
+    const __m128i down = _mm_set1_epi32(DOWN);
+    const __m128i left = _mm_set1_epi32(LEFT);
+    const __m128i right = _mm_set1_epi32(RIGHT);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lastX = _mm_set1_epi32(cols - 1);
+    const __m128i lastY = _mm_set1_epi32(rows - 1);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(action + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&direction[i]));
+        __m128i reverse = _mm_cmpeq_epi32(a, _mm_xor_si128(d, one));
+        d = _mm_or_si128(_mm_and_si128(reverse, d), _mm_andnot_si128(reverse, a));
+
+        // cmpeq trả về -1 khi đúng
+        __m128i dx = _mm_sub_epi32(_mm_cmpeq_epi32(d, left), _mm_cmpeq_epi32(d, right));
+        __m128i dy = _mm_sub_epi32(_mm_cmpeq_epi32(d, up), _mm_cmpeq_epi32(d, down));
+        __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&headX[i])), dx);
+        __m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&headY[i])), dy);
+
+        __m128i wall = _mm_or_si128(
+            _mm_or_si128(_mm_cmpgt_epi32(zero, x), _mm_cmpgt_epi32(x, lastX)),
+            _mm_or_si128(_mm_cmpgt_epi32(zero, y), _mm_cmpgt_epi32(y, lastY)));
+        __m128i food = _mm_and_si128(
+            _mm_cmpeq_epi32(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&foodX[i]))),
+            _mm_cmpeq_epi32(y, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&foodY[i]))));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&direction[i]), d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&headX[i]), x);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&headY[i]), y);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&hitWall[i]), wall);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&hitFood[i]), _mm_andnot_si128(wall, food));
+    }
+#endif
+
+    // Phần còn lại (hoặc toàn bộ nếu không có SIMD)
+    for (; i < count; i++) {
+        int d = direction[i];
+        if (action[i] != (d ^ 1)) {
+            d = action[i];
+        }
+        direction[i] = d;
+
+        int x = headX[i] + (d == RIGHT) - (d == LEFT);
+        int y = headY[i] + (d == DOWN) - (d == UP);
+        headX[i] = x;
+        headY[i] = y;
+
+        bool wall = x < 0 || x >= cols || y < 0 || y >= rows;
+        hitWall[i] = wall ? -1 : 0;
+        hitFood[i] = (!wall && x == foodX[i] && y == foodY[i]) ? -1 : 0;
+    }
+}
+
+StepResult BatchSim::finishStep(int env) {
+    ticks[env]++;
+
+    if (hitWall[env]) {
+        return STEP_DIED;
+    }
+
+    uint16_t* ring = &body[static_cast<size_t>(env) * capacity];
+
+    // Bỏ đuôi; ô chỉ được giải phóng khi đuôi không bị nhân đôi bởi grow()
+    int tail = ringHead[env] + length[env] - 1;
+    if (tail >= capacity) {
+        tail -= capacity;
+    }
+    int tailCell = ring[tail];
+    length[env]--;
+    if (ring[tail == 0 ? capacity - 1 : tail - 1] != tailCell) {
+        release(env, tailCell);
+    }
+
+    // Thêm đầu; ô đã bị chiếm nghĩa là rắn cắn vào thân
+    int headCell = headY[env] * cols + headX[env];
+    if (isOccupied(env, headX[env], headY[env])) {
+        return STEP_DIED;
+    }
+    occupy(env, headCell);
+    ringHead[env] = (ringHead[env] == 0) ? capacity - 1 : ringHead[env] - 1;
+    ring[ringHead[env]] = headCell;
+    length[env]++;
+
+    if (!hitFood[env]) {
+        return STEP_NONE;
+    }
+
+    // Ăn mồi: nhân đôi đoạn đuôi như Snake::grow()
+    int newTail = ringHead[env] + length[env];
+    if (newTail >= capacity) {
+        newTail -= capacity;
+    }
+    ring[newTail] = ring[newTail == 0 ? capacity - 1 : newTail - 1];
+    length[env]++;
+    score[env] += GameSim::FOOD_SCORE;
+
+    return spawnFood(env) ? STEP_ATE : STEP_WON;
+}
+
+void BatchSim::step(const Direction* actions) {
+    moveHeads(actions);
+
+    for (int i = 0; i < count; i++) {
+        StepResult result = finishStep(i);
+        results[i] = static_cast<int8_t>(result);
+
+        if (result == STEP_DIED || result == STEP_WON) {
+            episodeScore[i] = score[i];
+            episodeTicks[i] = ticks[i];
+            resetEnv(i);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include <vector>
+#include <cstdint>
+#include "GameSim.h"
+#include "Random.h"
+
+// Chạy song song N ván rắn độc lập, dữ liệu lưu dạng struct-of-arrays.
+// Tọa độ tính theo ô (không phải điểm ảnh). Cùng seed và cùng dãy hướng đi,
+// mỗi ván cho kết quả giống hệt GameSim (tường, +10 điểm, grow(), mồi).
+// Ván nào kết thúc sẽ tự động bắt đầu lại ngay trong step(), tiếp tục dãy ngẫu nhiên cũ.
+class BatchSim {
+private:
+    int count;
+    int cols;
+    int rows;
+    int cells;
+    int capacity;   // Sức chứa bộ đệm vòng của mỗi ván (cells + 1)
+    int bitWords;   // Số từ 64 bit của bitset chiếm chỗ mỗi ván
+
+    // Trạng thái theo từng ván
+    std::vector<int32_t> headX;
+    std::vector<int32_t> headY;
+    std::vector<int32_t> direction;
+    std::vector<int32_t> foodX;
+    std::vector<int32_t> foodY;
+    std::vector<int32_t> length;
+    std::vector<int32_t> ringHead;
+    std::vector<int32_t> score;
+    std::vector<int32_t> ticks;
+    std::vector<int32_t> freeCount;
+    std::vector<Random> random;
+
+    // Kết quả tạm của phần vector hóa
+    std::vector<int32_t> hitWall;
+    std::vector<int32_t> hitFood;
+
+    // Kết quả của bước gần nhất
+    std::vector<int8_t> results;
+    std::vector<int32_t> episodeScore;
+    std::vector<int32_t> episodeTicks;
+
+    // Dữ liệu lớn, mỗi ván một khối liền nhau
+    std::vector<uint16_t> body;      // count * capacity, chỉ số ô
+    std::vector<uint64_t> occupied;  // count * bitWords
+    std::vector<uint16_t> freeCells; // count * cells
+    std::vector<uint16_t> slotOf;    // count * cells
+
+    // Trạng thái ban đầu giống nhau ở mọi ván, chép một lần khi khởi động lại
+    std::vector<uint64_t> startOccupied;
+    std::vector<uint16_t> startFreeCells;
+    std::vector<uint16_t> startSlotOf;
+
+    void moveHeads(const Direction* actions);
+    void resetEnv(int env);
+    void occupy(int env, int cell);
+    void release(int env, int cell);
+    bool spawnFood(int env);
+    StepResult finishStep(int env);
+
+public:
+    static const int MAX_CELLS = 65535; // Chỉ số ô lưu bằng uint16_t
+
+    // Bàn chơi không hợp lệ (xem isValidSize()) thì không có ván nào: getCount() == 0
+    BatchSim(int count, int cols, int rows);
+    static bool isValidSize(int cols, int rows);
+
+    // Ván thứ i dùng seed + i, giống GameSim::reset(seed + i)
+    void reset(unsigned int seed);
+    void step(const Direction* actions);
+
+    int getCount() const { return count; }
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+
+    const int32_t* getHeadX() const { return headX.data(); }
+    const int32_t* getHeadY() const { return headY.data(); }
+    const int32_t* getDirections() const { return direction.data(); }
+    const int32_t* getFoodX() const { return foodX.data(); }
+    const int32_t* getFoodY() const { return foodY.data(); }
+    const int32_t* getLengths() const { return length.data(); }
+    const int32_t* getScores() const { return score.data(); }
+
+    // StepResult của bước gần nhất; với STEP_DIED/STEP_WON ván đã được khởi động lại
+    // và episodeScore/episodeTicks giữ kết quả của ván vừa kết thúc
+    const int8_t* getResults() const { return results.data(); }
+    const int32_t* getEpisodeScores() const { return episodeScore.data(); }
+    const int32_t* getEpisodeTicks() const { return episodeTicks.data(); }
+
+    bool isOccupied(int env, int col, int row) const {
+        int cell = row * cols + col;
+        return (occupied[env * bitWords + (cell >> 6)] >> (cell & 63)) & 1;
+    }
+
+    // Đoạn thứ i của rắn (0 là đầu), trả về chỉ số ô row * cols + col
+    int getSegment(int env, int i) const {
+        int p = ringHead[env] + i;
+        if (p >= capacity) {
+            p -= capacity;
+        }
+        return body[env * capacity + p];
+    }
+};
+
+#endif // BATCHSIM_H
@@ -0,0 +1,363 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "GameSim.h"
+#include "ArenaSim.h"
+#include "Autopilot.h"
+
+// snake_bench: đo các đường nóng của mô phỏng (Snake::move, Snake::grow,
+// Snake::checkSelfCollision, Food::generate, một bước GameSim::step, một quyết
+// định của Autopilot và một bước ArenaSim::step) với nhiều độ dài rắn, số rắn
+// và kích thước bàn chơi. Kết quả là ns/op và số lần cấp phát/op, in ra CSV
+// (mặc định) hoặc JSON để so sánh giữa các bản build.
+//
+//   snake_bench [--json] [--out file] [--min-ms 20]
+
+namespace {
+
+// Đếm mọi lần cấp phát trong chương trình (chỉ một luồng nên không cần atomic)
+long long allocationCount = 0;
+
+}
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+namespace {
+
+struct BenchResult {
+    std::string name;
+    int cols;
+    int rows;
+    int length;
+    double nsPerOp;
+    double allocsPerOp;
+    long long ops;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double minSeconds = 0.02;
+volatile int sink = 0; // Giữ kết quả để trình biên dịch không bỏ vòng đo
+
+// Chu trình Hamilton trên bàn có số hàng chẵn: hàng 0 sang phải, các hàng sau
+// chạy zigzag trên cột 1..cols-1, rồi về theo cột 0. Đi theo nó rắn không bao giờ chết.
+Direction cycleDirection(int x, int y, int cols, int rows) {
+    if (x == 0) {
+        return y == 0 ? RIGHT : UP;
+    }
+    if (y % 2 == 0) {
+        return x < cols - 1 ? RIGHT : DOWN;
+    }
+    if (x > 1) {
+        return LEFT;
+    }
+    return y == rows - 1 ? LEFT : DOWN;
+}
+
+// Rắn dài length nằm trên chu trình, đầu hướng theo chu trình
+Snake buildSnake(int cols, int rows, int length) {
+    Snake snake(1, cols, rows);
+    snake.init(2, 0);
+    while (static_cast<int>(snake.getSegments().size()) < length) {
+        SnakeSegment head = snake.getHead();
+        snake.setDirection(cycleDirection(head.x, head.y, cols, rows));
+        snake.move();
+        snake.grow();
+    }
+    return snake;
+}
+
+// Bản sao để đo không được tính vào số lần cấp phát của phép đo
+Snake copyUncounted(const Snake& snake) {
+    long long allocationsBefore = allocationCount;
+    Snake copy = snake;
+    allocationCount = allocationsBefore;
+    return copy;
+}
+
+// Chạy fn(ops) với số op tăng dần tới khi đủ minSeconds, trả về kết quả của lần cuối
+template <typename Fn>
+BenchResult measure(const char* name, int cols, int rows, int length, Fn fn) {
+    long long ops = 64;
+    while (true) {
+        long long allocationsBefore = allocationCount;
+        Clock::time_point start = Clock::now();
+        long long done = fn(ops);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        long long allocations = allocationCount - allocationsBefore;
+
+        if (seconds >= minSeconds || ops >= (1LL << 32)) {
+            BenchResult result;
+            result.name = name;
+            result.cols = cols;
+            result.rows = rows;
+            result.length = length;
+            result.nsPerOp = seconds * 1e9 / done;
+            result.allocsPerOp = static_cast<double>(allocations) / done;
+            result.ops = done;
+            return result;
+        }
+        ops *= 2;
+    }
+}
+
+void benchSnake(int cols, int rows, int length, std::vector<BenchResult>& results) {
+    const Snake start = buildSnake(cols, rows, length);
+
+    results.push_back(measure("move", cols, rows, length, [&](long long ops) {
+        Snake snake = copyUncounted(start);
+        for (long long i = 0; i < ops; i++) {
+            SnakeSegment head = snake.getHead();
+            snake.setDirection(cycleDirection(head.x, head.y, cols, rows));
+            snake.move();
+        }
+        sink += snake.getHead().x;
+        return ops;
+    }));
+
+    results.push_back(measure("checkSelfCollision", cols, rows, length, [&](long long ops) {
+        int hits = 0;
+        for (long long i = 0; i < ops; i++) {
+            hits += start.checkSelfCollision() ? 1 : 0;
+        }
+        sink += hits;
+        return ops;
+    }));
+
+    results.push_back(measure("generateFood", cols, rows, length, [&](long long ops) {
+        Food food(1, cols, rows);
+        food.seed(1);
+        for (long long i = 0; i < ops; i++) {
+            food.generate(start);
+        }
+        sink += food.getPosition().x;
+        return ops;
+    }));
+
+    // grow() thêm một đoạn nên chỉ làm được tới khi đầy bộ đệm; đo theo từng
+    // đợt trên bản sao (thời gian chép bản sao nằm trong phép đo, chia đều cho cả đợt).
+    // Mỗi lần grow() chồng thêm một đoạn lên ô đuôi, mà bộ đếm mỗi ô của Grid
+    // chỉ tới 255, nên một đợt phải nhỏ hơn thế.
+    int room = static_cast<int>(start.getSegments().capacity() - start.getSegments().size());
+    int batch = room < 128 ? room : 128;
+    if (batch > 0) {
+        results.push_back(measure("grow", cols, rows, length, [&](long long ops) {
+            long long done = 0;
+            long long copies = 0;
+            Snake snake = copyUncounted(start);
+            while (done < ops) {
+                for (int i = 0; i < batch; i++) {
+                    snake.grow();
+                }
+                done += batch;
+                if (done < ops) {
+                    long long allocationsBefore = allocationCount;
+                    snake = start;
+                    allocationCount = allocationsBefore;
+                    copies++;
+                }
+            }
+            sink += static_cast<int>(snake.getSegments().size() + copies);
+            return done;
+        }));
+    }
+}
+
+// Một bước GameSim::step như Game::tick(), đo quanh các độ dài mốc trong một
+// ván đi theo chu trình Hamilton (ăn hết mồi và không bao giờ chết)
+void benchTick(int cols, int rows, const std::vector<int>& lengths, std::vector<BenchResult>& results) {
+    // Mỗi cửa sổ đi tối đa một vòng chu trình (hoặc 256 bước) từ độ dài mốc, nên
+    // rắn không dài ra quá xa mốc; lặp lại tới khi đủ số op và thời gian tối thiểu
+    const int window = cols * rows < 256 ? cols * rows : 256;
+    const long long minOps = 4096;
+    GameSim sim(1, cols, rows);
+    sim.reset(1);
+
+    for (int length : lengths) {
+        while (!sim.isOver() && static_cast<int>(sim.getSnake().getSegments().size()) < length) {
+            SnakeSegment head = sim.getSnake().getHead();
+            sim.step(cycleDirection(head.x, head.y, cols, rows));
+        }
+        if (sim.isOver()) {
+            break;
+        }
+
+        // Cùng một trạng thái nên lặp lại được; lần gọi đầu cấp phát bộ đệm theo bàn
+        Autopilot autopilot;
+        autopilot.decide(sim);
+        results.push_back(measure("autopilot", cols, rows, length, [&](long long ops) {
+            int turns = 0;
+            for (long long i = 0; i < ops; i++) {
+                turns += autopilot.decide(sim);
+            }
+            sink += turns;
+            return ops;
+        }));
+
+        // Mỗi bước đổi trạng thái nên không lặp lại được cùng một bước: đo từng cửa
+        // sổ bắt đầu từ trạng thái ở độ dài mốc, và khôi phục trạng thái đó (không
+        // tính giờ, không tính cấp phát) mỗi khi hết cửa sổ hoặc rắn đã phủ kín bàn
+        GameSim start = sim;
+        GameSim run = sim;
+        long long done = 0;
+        long long allocations = 0;
+        double seconds = 0;
+        while (done < minOps || seconds < minSeconds) {
+            long long allocationsBefore = allocationCount;
+            run = start;
+            allocationCount = allocationsBefore;
+
+            Clock::time_point windowStart = Clock::now();
+            int steps = 0;
+            while (steps < window && !run.isOver()) {
+                SnakeSegment head = run.getSnake().getHead();
+                run.step(cycleDirection(head.x, head.y, cols, rows));
+                steps++;
+            }
+            seconds += std::chrono::duration<double>(Clock::now() - windowStart).count();
+            allocations += allocationCount - allocationsBefore;
+            done += steps;
+        }
+
+        BenchResult result;
+        result.name = "tick";
+        result.cols = cols;
+        result.rows = rows;
+        result.length = length;
+        result.nsPerOp = seconds * 1e9 / done;
+        result.allocsPerOp = static_cast<double>(allocations) / done;
+        result.ops = done;
+        results.push_back(result);
+    }
+}
+
+// Một bước đấu trường gồm cả quyết định của mọi bot; "length" là số rắn.
+// Chi phí phải tăng theo số rắn, không theo tổng số đoạn thân.
+void benchArena(int cols, int rows, int snakeCount, std::vector<BenchResult>& results) {
+    ArenaSim arena(cols, rows, snakeCount, snakeCount * 2);
+    arena.reset(1);
+    std::vector<Direction> actions(snakeCount);
+
+    // Chạy trước một lúc để rắn kịp dài ra và chết, hồi sinh như khi chơi thật
+    for (int i = 0; i < 200; i++) {
+        for (int s = 0; s < snakeCount; s++) {
+            actions[s] = arena.decideBot(s);
+        }
+        arena.step(actions.data());
+    }
+
+    results.push_back(measure("arenaTick", cols, rows, snakeCount, [&](long long ops) {
+        for (long long i = 0; i < ops; i++) {
+            for (int s = 0; s < snakeCount; s++) {
+                actions[s] = arena.decideBot(s);
+            }
+            arena.step(actions.data());
+        }
+        sink += arena.getAliveCount();
+        return ops;
+    }));
+}
+
+}
+
+int main(int argc, char* args[]) {
+    bool json = false;
+    std::string out;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            out = args[++i];
+        } else if (arg == "--min-ms" && i + 1 < argc) {
+            minSeconds = atof(args[++i]) / 1000.0;
+        } else {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Số hàng phải chẵn cho chu trình, và rows / 2 chẵn để hướng ban đầu của
+    // GameSim (sang phải ở hàng giữa) trùng với chu trình
+    const int boards[][2] = {{8, 8}, {16, 16}, {32, 24}, {64, 64}};
+
+    std::vector<BenchResult> results;
+    for (const auto& board : boards) {
+        int cols = board[0];
+        int rows = board[1];
+        int cells = cols * rows;
+
+        // Từ 3 đoạn tới gần kín bàn
+        std::vector<int> lengths;
+        const double fractions[] = {0.1, 0.25, 0.5, 0.75, 0.9};
+        lengths.push_back(3);
+        for (double fraction : fractions) {
+            int length = static_cast<int>(cells * fraction);
+            if (length > lengths.back()) {
+                lengths.push_back(length);
+            }
+        }
+        lengths.push_back(cells - 2);
+
+        for (int length : lengths) {
+            benchSnake(cols, rows, length, results);
+        }
+        benchTick(cols, rows, lengths, results);
+    }
+
+    const int snakeCounts[] = {10, 100, 1000};
+    for (int snakeCount : snakeCounts) {
+        benchArena(512, 512, snakeCount, results);
+    }
+
+    FILE* file = out.empty() ? stdout : fopen(out.c_str(), "w");
+    if (!file) {
+        std::cerr << "Không thể ghi file " << out << std::endl;
+        return 1;
+    }
+
+    if (json) {
+        fprintf(file, "[\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            fprintf(file, "  {\"benchmark\": \"%s\", \"cols\": %d, \"rows\": %d, \"length\": %d, "
+                          "\"ns_per_op\": %.2f, \"allocs_per_op\": %.4f, \"ops\": %lld}%s\n",
+                    r.name.c_str(), r.cols, r.rows, r.length, r.nsPerOp, r.allocsPerOp, r.ops,
+                    i + 1 < results.size() ? "," : "");
+        }
+        fprintf(file, "]\n");
+    } else {
+        fprintf(file, "benchmark,cols,rows,length,ns_per_op,allocs_per_op,ops\n");
+        for (const BenchResult& r : results) {
+            fprintf(file, "%s,%d,%d,%d,%.2f,%.4f,%lld\n",
+                    r.name.c_str(), r.cols, r.rows, r.length, r.nsPerOp, r.allocsPerOp, r.ops);
+        }
+    }
+
+    if (file != stdout) {
+        fclose(file);
+    }
+    return 0;
+}
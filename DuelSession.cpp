@@ -0,0 +1,513 @@
+#include "DuelSession.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include "ArenaProtocol.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const uint8_t DUEL_PROTOCOL_VERSION = 1;
+const int HANDSHAKE_INTERVAL_MS = 200;
+
+enum DuelPacketType {
+    DUEL_PACKET_HELLO = 1,      // Máy tham gia gửi lặp lại cho tới khi nhận START
+    DUEL_PACKET_START = 2,      // Máy chủ trả lời mỗi HELLO: seed của trận
+    DUEL_PACKET_INPUTS = 3
+};
+
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+
+bool startSockets() {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+void closeSocket(NativeSocket socket) {
+    closesocket(socket);
+    WSACleanup();
+}
+
+bool setNonBlocking(NativeSocket socket) {
+    u_long mode = 1;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+}
+#else
+typedef int NativeSocket;
+
+bool startSockets() {
+    return true;
+}
+
+void closeSocket(NativeSocket socket) {
+    ::close(socket);
+}
+
+bool setNonBlocking(NativeSocket socket) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+NativeSocket toNative(intptr_t fd) {
+    return static_cast<NativeSocket>(fd);
+}
+
+}
+
+DuelSession::DuelSession(int cols, int rows)
+    : fd(-1), peerAddress(0), peerPort(0), peerKnown(false), hosting(false), started(false),
+      matchSeed(0), playerIndex(0), sim(cols, rows),
+      confirmedTick(-1), rollbackFrom(-1), peerAck(-1), peerTick(0), peerAdvantage(0),
+      peerHashTick(-1), peerHash(0), checkedTick(-1), desyncTick(-1),
+      peerTime(0), hasPeerTime(false),
+      latencyMs(0), jitterMs(0), lossRate(0), linkRandom(static_cast<uint64_t>(time(nullptr))), delayedCount(0) {
+    memset(&stats, 0, sizeof(stats));
+    memset(localInputs, 0, sizeof(localInputs));
+    memset(remoteInputs, 0, sizeof(remoteInputs));
+    memset(localHashes, 0, sizeof(localHashes));
+}
+
+DuelSession::~DuelSession() {
+    close();
+}
+
+bool DuelSession::openSocket(int port) {
+    close();
+    if (!startSockets()) {
+        std::cerr << "Không khởi tạo được socket" << std::endl;
+        return false;
+    }
+
+    NativeSocket socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    fd = static_cast<intptr_t>(socket);
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (fd == -1 || bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        !setNonBlocking(socket)) {
+        std::cerr << "Không mở được cổng UDP " << port << std::endl;
+        close();
+        return false;
+    }
+
+    openedAt = Clock::now();
+    lastHandshake = openedAt - std::chrono::milliseconds(HANDSHAKE_INTERVAL_MS);
+    return true;
+}
+
+bool DuelSession::host(int port) {
+    if (!openSocket(port)) {
+        return false;
+    }
+    hosting = true;
+    playerIndex = 0;
+    return true;
+}
+
+bool DuelSession::join(const std::string& address, int port) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (!startSockets()) {
+        return false;
+    }
+    int error = getaddrinfo(address.c_str(), service.c_str(), &hints, &result);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    if (error != 0 || result == nullptr) {
+        std::cerr << "Không tìm được máy " << address << std::endl;
+        return false;
+    }
+    const sockaddr_in* resolved = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    uint32_t resolvedAddress = resolved->sin_addr.s_addr;
+    uint16_t resolvedPort = resolved->sin_port;
+    freeaddrinfo(result);
+
+    if (!openSocket(0)) {
+        return false;
+    }
+    peerAddress = resolvedAddress;
+    peerPort = resolvedPort;
+    peerKnown = true;
+    hosting = false;
+    playerIndex = 1;
+    return true;
+}
+
+void DuelSession::close() {
+    if (fd != -1) {
+        closeSocket(toNative(fd));
+        fd = -1;
+    }
+    peerKnown = false;
+    started = false;
+    delayedCount = 0;
+}
+
+int DuelSession::getPort() const {
+    sockaddr_in address;
+    socklen_t length = sizeof(address);
+    if (fd == -1 || getsockname(toNative(fd), reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+void DuelSession::setLinkConditions(int latency, int jitter, double loss) {
+    latencyMs = std::max(0, latency);
+    jitterMs = std::max(0, std::min(jitter, latencyMs));
+    lossRate = loss;
+}
+
+uint32_t DuelSession::clockMs() const {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - openedAt).count());
+}
+
+void DuelSession::sendRaw(const uint8_t* data, int size) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = peerAddress;
+    address.sin_port = peerPort;
+    sendto(toNative(fd), reinterpret_cast<const char*>(data), size, 0,
+           reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+}
+
+void DuelSession::sendPacket(const uint8_t* data, int size) {
+    if (fd == -1 || !peerKnown) {
+        return;
+    }
+    stats.packetsSent++;
+
+    if (lossRate > 0 && linkRandom.next() < lossRate * 4294967296.0) {
+        stats.packetsDropped++;
+        return;
+    }
+    if (latencyMs == 0 || delayedCount == MAX_DELAYED) {
+        sendRaw(data, size);
+        return;
+    }
+
+    // Độ trễ khác nhau giữa các gói nên gói có thể tới không theo thứ tự, như mạng thật
+    int delay = latencyMs;
+    if (jitterMs > 0) {
+        delay += static_cast<int>(linkRandom.nextBelow(2 * jitterMs + 1)) - jitterMs;
+    }
+    DelayedPacket& packet = delayed[delayedCount++];
+    packet.sendAt = Clock::now() + std::chrono::milliseconds(delay);
+    packet.size = size;
+    memcpy(packet.data, data, size);
+}
+
+void DuelSession::flushDelayed() {
+    Clock::time_point now = Clock::now();
+    for (int i = 0; i < delayedCount;) {
+        if (delayed[i].sendAt <= now) {
+            sendRaw(delayed[i].data, delayed[i].size);
+            delayed[i] = delayed[--delayedCount];
+        } else {
+            i++;
+        }
+    }
+}
+
+void DuelSession::sendHandshake() {
+    uint8_t packet[8];
+    PacketWriter writer(packet, sizeof(packet));
+    writer.bytes(hosting ? DUEL_PACKET_START : DUEL_PACKET_HELLO, 1);
+    writer.bytes(DUEL_PROTOCOL_VERSION, 1);
+    writer.bytes(matchSeed, 4);
+    sendPacket(packet, static_cast<int>(writer.size()));
+}
+
+void DuelSession::sendInputs() {
+    int tick = sim.getTick();
+    int hashTick = std::min(confirmedTick, tick - 1);
+    uint32_t echo = 0;
+    if (hasPeerTime) {
+        // Trả lại đồng hồ của đối thủ, cộng thời gian nó nằm chờ ở đây
+        echo = peerTime + static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - peerTimeAt).count());
+    }
+
+    // Mọi hướng đi đối thủ chưa xác nhận. Hai bên không thể cách nhau quá MAX_ROLLBACK
+    // bước chưa xác nhận, nên đối thủ chắc chắn đã có những hướng cũ hơn 2 * MAX_ROLLBACK
+    // bước (peerAck có thể đã cũ vì gói trả lời bị mất)
+    int first = std::max(peerAck + 1, tick - 2 * MAX_ROLLBACK - 1);
+    first = std::max(first, 0);
+
+    uint8_t packet[MAX_PACKET];
+    PacketWriter writer(packet, sizeof(packet));
+    writer.bytes(DUEL_PACKET_INPUTS, 1);
+    writer.bytes(static_cast<uint32_t>(tick), 4);
+    writer.bytes(static_cast<uint16_t>(static_cast<int16_t>(tick - peerTick)), 2);
+    writer.bytes(static_cast<uint32_t>(confirmedTick + 1), 4);
+    writer.bytes(static_cast<uint32_t>(hashTick + 1), 4);
+    writer.bytes(hashTick >= 0 ? localHashes[hashTick & (HISTORY - 1)] : 0, 8);
+    writer.bytes(clockMs(), 4);
+    writer.bytes(echo, 4);
+    writer.bytes(static_cast<uint32_t>(first), 4);
+    writer.bytes(static_cast<uint32_t>(tick - first), 1);
+    for (int t = first; t < tick; t++) {
+        writer.bytes(localInputs[t & (HISTORY - 1)], 1);
+    }
+    sendPacket(packet, static_cast<int>(writer.size()));
+}
+
+void DuelSession::poll() {
+    if (fd == -1) {
+        return;
+    }
+
+    uint8_t packet[MAX_PACKET];
+    while (true) {
+        sockaddr_in from;
+        socklen_t length = sizeof(from);
+        int size = static_cast<int>(recvfrom(toNative(fd), reinterpret_cast<char*>(packet), sizeof(packet), 0,
+                                             reinterpret_cast<sockaddr*>(&from), &length));
+        if (size <= 0) {
+            break;
+        }
+        handlePacket(packet, size, from.sin_addr.s_addr, from.sin_port);
+    }
+
+    // Máy tham gia chào lặp lại cho tới khi máy chủ trả lời
+    Clock::time_point now = Clock::now();
+    if (!started && !hosting && now - lastHandshake >= std::chrono::milliseconds(HANDSHAKE_INTERVAL_MS)) {
+        sendHandshake();
+        lastHandshake = now;
+    }
+    flushDelayed();
+}
+
+void DuelSession::handlePacket(const uint8_t* data, int size, uint32_t address, uint16_t port) {
+    if (size < 2) {
+        return;
+    }
+    if (peerKnown && (address != peerAddress || port != peerPort)) {
+        return;
+    }
+    stats.packetsReceived++;
+
+    PacketReader reader(data, static_cast<size_t>(size));
+    uint8_t type = static_cast<uint8_t>(reader.bytes(1));
+    if (type == DUEL_PACKET_HELLO && hosting) {
+        if (reader.bytes(1) != DUEL_PROTOCOL_VERSION) {
+            return;
+        }
+        // Đối thủ đầu tiên chào là đối thủ của cả trận; START bị mất thì nó chào lại
+        peerAddress = address;
+        peerPort = port;
+        peerKnown = true;
+        if (!started) {
+            start(static_cast<uint32_t>(time(nullptr)) ^ linkRandom.next());
+        }
+        sendHandshake();
+    } else if (type == DUEL_PACKET_START && !hosting) {
+        if (reader.bytes(1) != DUEL_PROTOCOL_VERSION) {
+            return;
+        }
+        uint32_t seed = static_cast<uint32_t>(reader.bytes(4));
+        if (reader.isOk() && !started) {
+            start(seed);
+        }
+    } else if (type == DUEL_PACKET_INPUTS && started) {
+        receiveInputs(data, size);
+    }
+}
+
+void DuelSession::start(uint32_t seed) {
+    matchSeed = seed;
+    sim.reset(seed);
+    started = true;
+    confirmedTick = -1;
+    rollbackFrom = -1;
+    peerAck = -1;
+    peerTick = 0;
+    peerAdvantage = 0;
+    peerHashTick = -1;
+    checkedTick = -1;
+    desyncTick = -1;
+}
+
+void DuelSession::receiveInputs(const uint8_t* data, int size) {
+    PacketReader reader(data, static_cast<size_t>(size));
+    reader.bytes(1);
+    int remoteTick = static_cast<int>(reader.bytes(4));
+    int advantage = static_cast<int16_t>(reader.bytes(2));
+    int ack = static_cast<int>(reader.bytes(4)) - 1;
+    int hashTick = static_cast<int>(reader.bytes(4)) - 1;
+    uint64_t hash = reader.bytes(8);
+    uint32_t remoteTime = static_cast<uint32_t>(reader.bytes(4));
+    uint32_t echo = static_cast<uint32_t>(reader.bytes(4));
+    int first = static_cast<int>(reader.bytes(4));
+    int count = static_cast<int>(reader.bytes(1));
+    if (!reader.isOk()) {
+        return;
+    }
+
+    // Gói đến trễ (không theo thứ tự) thì không làm lùi các mốc đã biết
+    if (remoteTick >= peerTick) {
+        peerTick = remoteTick;
+        peerAdvantage = advantage;
+        peerTime = remoteTime;
+        peerTimeAt = Clock::now();
+        hasPeerTime = true;
+    }
+    peerAck = std::max(peerAck, ack);
+    if (hashTick > peerHashTick) {
+        peerHashTick = hashTick;
+        peerHash = hash;
+    }
+    if (echo != 0) {
+        double sample = static_cast<double>(clockMs() - echo);
+        stats.rttMs = stats.rttMs == 0 ? sample : stats.rttMs * 0.9 + sample * 0.1;
+    }
+
+    int tick = sim.getTick();
+    for (int i = 0; i < count; i++) {
+        int t = first + i;
+        uint8_t input = static_cast<uint8_t>(reader.bytes(1));
+        if (!reader.isOk() || input > RIGHT) {
+            return;
+        }
+        if (t <= confirmedTick) {
+            continue;
+        }
+        if (t != confirmedTick + 1) {
+            return;
+        }
+
+        // Bước đã chạy bằng dự đoán: sai thì phải mô phỏng lại từ đó
+        uint8_t& slot = remoteInputs[t & (HISTORY - 1)];
+        if (t < tick && slot != input && (rollbackFrom < 0 || t < rollbackFrom)) {
+            rollbackFrom = t;
+        }
+        slot = input;
+        confirmedTick = t;
+    }
+}
+
+Direction DuelSession::predictRemote() const {
+    if (confirmedTick >= 0) {
+        return static_cast<Direction>(remoteInputs[confirmedTick & (HISTORY - 1)]);
+    }
+    return static_cast<Direction>(sim.getState().snakes[1 - playerIndex].direction);
+}
+
+void DuelSession::simulate(int tick) {
+    int slot = tick & (HISTORY - 1);
+    if (tick > confirmedTick) {
+        remoteInputs[slot] = static_cast<uint8_t>(predictRemote());
+    }
+
+    Direction inputs[2];
+    inputs[playerIndex] = static_cast<Direction>(localInputs[slot]);
+    inputs[1 - playerIndex] = static_cast<Direction>(remoteInputs[slot]);
+
+    sim.save(states[slot]);
+    sim.step(inputs);
+    localHashes[slot] = sim.getStateHash();
+}
+
+void DuelSession::rollback() {
+    if (rollbackFrom < 0) {
+        return;
+    }
+    Clock::time_point begin = Clock::now();
+
+    int from = rollbackFrom;
+    int tick = sim.getTick();
+    rollbackFrom = -1;
+    sim.restore(states[from & (HISTORY - 1)]);
+    for (int t = from; t < tick; t++) {
+        simulate(t);
+    }
+
+    double micros = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+    stats.rollbacks++;
+    stats.resimulatedTicks += tick - from;
+    stats.maxRollback = std::max(stats.maxRollback, tick - from);
+    stats.maxResimMicros = std::max(stats.maxResimMicros, micros);
+}
+
+void DuelSession::checkHash() {
+    int tick = sim.getTick();
+    int limit = std::min(confirmedTick, tick - 1);
+    if (peerHashTick <= checkedTick || peerHashTick > limit || peerHashTick <= tick - HISTORY) {
+        return;
+    }
+    if (localHashes[peerHashTick & (HISTORY - 1)] != peerHash && desyncTick < 0) {
+        desyncTick = peerHashTick;
+        std::cerr << "Đấu tay đôi: lệch trạng thái với đối thủ ở bước " << peerHashTick << std::endl;
+    }
+    checkedTick = peerHashTick;
+}
+
+bool DuelSession::canAdvance() const {
+    if (!started) {
+        return false;
+    }
+
+    // Chưa nhận được hướng đi của đối thủ quá lâu: đoán tiếp sẽ phải rollback quá sâu
+    int tick = sim.getTick();
+    bool tooFar = tick - confirmedTick > MAX_ROLLBACK;
+    // Cả hai cùng tính "mình đi trước bao nhiêu" theo gói mới nhất (cùng lệch độ trễ
+    // một chiều); hiệu hai số là hai lần khoảng cách thật
+    bool ahead = (tick - peerTick) - peerAdvantage >= 2;
+    return !tooFar && !ahead;
+}
+
+bool DuelSession::advance(Direction input) {
+    if (!started) {
+        return false;
+    }
+
+    rollback();
+    checkHash();
+
+    if (!canAdvance()) {
+        stats.stalls++;
+        sendInputs();
+        flushDelayed();
+        return false;
+    }
+
+    int tick = sim.getTick();
+    localInputs[tick & (HISTORY - 1)] = static_cast<uint8_t>(input);
+    simulate(tick);
+    stats.ticks++;
+
+    sendInputs();
+    flushDelayed();
+    return true;
+}
+
+Direction DuelSession::getInput(int player, int tick) const {
+    const uint8_t* inputs = (player == playerIndex) ? localInputs : remoteInputs;
+    return static_cast<Direction>(inputs[tick & (HISTORY - 1)]);
+}
@@ -0,0 +1,148 @@
+#ifndef DUELSESSION_H
+#define DUELSESSION_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "DuelSim.h"
+#include "Random.h"
+
+struct DuelStats {
+    long long ticks;
+    long long rollbacks;            // Số lần phải mô phỏng lại vì đoán sai hướng của đối thủ
+    long long resimulatedTicks;
+    int maxRollback;                // Số bước mô phỏng lại nhiều nhất trong một lần
+    double maxResimMicros;          // Thời gian khôi phục + mô phỏng lại lâu nhất trong một lần
+    long long stalls;               // Số lần advance() phải chờ đối thủ
+    long long packetsSent;
+    long long packetsDropped;       // Bị bỏ do giả lập mất gói
+    long long packetsReceived;
+    double rttMs;                   // Trung bình trượt của thời gian khứ hồi
+};
+
+// Đấu tay đôi ngang hàng qua UDP với dự đoán và rollback.
+//
+// Mỗi bước, hướng đi của người chơi được áp dụng ngay; hướng của đối thủ nếu chưa
+// tới thì đoán là giữ nguyên hướng gần nhất đã biết. Khi hướng thật tới mà khác dự
+// đoán, trạng thái được khôi phục về bước sai đầu tiên (mỗi bước chưa xác nhận có
+// một DuelState lưu sẵn) rồi mô phỏng lại tới bước hiện tại. Mỗi gói mang mọi hướng
+// đi đối thủ chưa xác nhận, nên mất gói chỉ làm chậm xác nhận chứ không cần gửi lại.
+//
+// Hai bên gửi kèm mã băm trạng thái của bước đã xác nhận mới nhất để phát hiện lệch.
+// Đi trước đối thủ quá MAX_ROLLBACK bước thì dừng chờ; đi trước nhiều hơn đối thủ
+// đi trước mình thì nhường một bước để hai bên đồng nhịp. advance() không bao giờ
+// chặn: vòng lặp của Game vẫn vẽ bình thường trong lúc chờ mạng.
+class DuelSession {
+private:
+    static const int HISTORY = 32;              // Lũy thừa của 2, >= 2 * MAX_ROLLBACK + 2
+    static const int MAX_DELAYED = 256;         // Gói đang bị giữ lại để giả lập độ trễ
+    static const int MAX_PACKET = 128;
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct DelayedPacket {
+        Clock::time_point sendAt;
+        int size;
+        uint8_t data[MAX_PACKET];
+    };
+
+    intptr_t fd;                    // Socket UDP, -1 nếu chưa mở
+    uint32_t peerAddress;           // Theo thứ tự byte mạng
+    uint16_t peerPort;
+    bool peerKnown;
+    bool hosting;
+    bool started;
+    uint32_t matchSeed;
+    int playerIndex;                // 0: máy chủ, 1: máy tham gia
+    Clock::time_point openedAt;
+    Clock::time_point lastHandshake;
+
+    DuelSim sim;
+    DuelState states[HISTORY];      // states[t % HISTORY]: trạng thái trước bước t
+    uint8_t localInputs[HISTORY];
+    uint8_t remoteInputs[HISTORY];  // Đã biết nếu t <= confirmedTick, còn lại là dự đoán đã dùng
+    int confirmedTick;              // Bước cuối mà mọi hướng đi của đối thủ đã tới, -1 nếu chưa có
+    int rollbackFrom;               // Bước dự đoán sai sớm nhất, -1 nếu không có
+    int peerAck;                    // Bước cuối của mình mà đối thủ đã nhận
+    int peerTick;                   // Số bước đối thủ đã chạy, theo gói mới nhất
+    int peerAdvantage;              // Đối thủ đi trước mình bao nhiêu bước, theo đối thủ
+
+    uint64_t localHashes[HISTORY];  // Của trạng thái sau bước t
+    int peerHashTick;               // Mã băm mới nhất đối thủ gửi, -1 nếu chưa có
+    uint64_t peerHash;
+    int checkedTick;                // Bước mới nhất đã so mã băm với đối thủ
+    int desyncTick;                 // -1 nếu chưa lệch
+
+    // Đo thời gian khứ hồi: mỗi gói mang đồng hồ của bên gửi và trả lại đồng hồ của bên kia
+    uint32_t peerTime;
+    Clock::time_point peerTimeAt;
+    bool hasPeerTime;
+
+    // Giả lập đường truyền xấu trên chiều gửi
+    int latencyMs;
+    int jitterMs;
+    double lossRate;
+    Random linkRandom;
+    DelayedPacket delayed[MAX_DELAYED];
+    int delayedCount;
+
+    DuelStats stats;
+
+    bool openSocket(int port);
+    uint32_t clockMs() const;
+    void sendPacket(const uint8_t* data, int size);
+    void sendRaw(const uint8_t* data, int size);
+    void flushDelayed();
+    void sendHandshake();
+    void sendInputs();
+    void handlePacket(const uint8_t* data, int size, uint32_t address, uint16_t port);
+    void receiveInputs(const uint8_t* data, int size);
+    void start(uint32_t seed);
+    Direction predictRemote() const;
+    void simulate(int tick);
+    void rollback();
+    void checkHash();
+
+public:
+    static const int MAX_ROLLBACK = 12;     // Số bước chưa xác nhận tối đa (1,2 s ở nhịp 100 ms)
+
+    DuelSession(int cols, int rows);
+    ~DuelSession();
+
+    // Chờ đối thủ ở cổng port (0: để hệ điều hành chọn, xem getPort())
+    bool host(int port);
+    // Tham gia trận của máy chủ address:port
+    bool join(const std::string& address, int port);
+    void close();
+
+    // Giả lập độ trễ một chiều latency ± jitter ms và tỉ lệ mất gói loss (0..1) cho mọi gói gửi đi
+    void setLinkConditions(int latency, int jitter, double loss);
+
+    // Đọc gói đang chờ và gửi các gói tới hạn; gọi được bất cứ lúc nào, không chặn
+    void poll();
+    // advance() có chạy bước kế tiếp không. Chỉ poll() mới đổi được câu trả lời, nên
+    // có thể hỏi trước rồi mới lấy hướng đi của bước đó.
+    bool canAdvance() const;
+    // Chạy một bước với hướng đi của người chơi. Trả về false (và không chạy) nếu chưa
+    // bắt đầu hoặc đang phải chờ đối thủ. Không tự poll(): gọi poll() trước.
+    bool advance(Direction input);
+
+    bool isStarted() const { return started; }
+    bool isDesynced() const { return desyncTick >= 0; }
+    int getDesyncTick() const { return desyncTick; }
+    int getPlayerIndex() const { return playerIndex; }
+    int getPort() const;
+    int getConfirmedTick() const { return confirmedTick; }
+    int getCheckedTick() const { return checkedTick; }
+    uint32_t getSeed() const { return matchSeed; }
+    // Hướng đi của người chơi player ở bước tick; chỉ còn với khoảng MAX_ROLLBACK bước gần nhất
+    Direction getInput(int player, int tick) const;
+    // Mã băm trạng thái sau bước tick, cùng giới hạn như getInput()
+    uint64_t getHash(int tick) const { return localHashes[tick & (HISTORY - 1)]; }
+
+    const DuelSim& getSim() const { return sim; }
+    const DuelStats& getStats() const { return stats; }
+};
+
+#endif // DUELSESSION_H
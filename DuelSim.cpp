@@ -0,0 +1,204 @@
+#include "DuelSim.h"
+
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<DuelState>::value, "DuelState phải chép được bằng memcpy");
+
+namespace {
+
+const int RING_MASK = DUEL_MAX_CELLS - 1;
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t hashInt(uint64_t hash, int value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++) {
+        hash ^= (bits >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+}
+
+DuelSim::DuelSim(int cols, int rows)
+    : cols(cols), rows(rows) {
+    state = DuelState();
+    reset(1);
+}
+
+void DuelSim::reset(unsigned int seed) {
+    state.tick = 0;
+    state.round = 0;
+    state.wins[0] = 0;
+    state.wins[1] = 0;
+    state.random.seed(seed);
+    startRound();
+}
+
+void DuelSim::placeSnake(int index, int col, int row, Direction direction) {
+    DuelSnakeState& snake = state.snakes[index];
+    int dx = (direction == RIGHT) ? -1 : 1;
+
+    snake.head = 0;
+    snake.length = INITIAL_LENGTH;
+    for (int i = 0; i < INITIAL_LENGTH; i++) {
+        int cell = row * cols + col + i * dx;
+        snake.body[i] = static_cast<uint16_t>(cell);
+        state.cells[cell] = 1;
+    }
+    snake.lastTail = snake.body[INITIAL_LENGTH - 1];
+    snake.direction = static_cast<uint8_t>(direction);
+    snake.alive = 1;
+    snake.score = 0;
+}
+
+void DuelSim::startRound() {
+    memset(state.cells, 0, sizeof(state.cells));
+
+    // Hai rắn đối xứng qua tâm bàn, quay mặt vào nhau
+    int row = rows / 3;
+    placeSnake(0, INITIAL_LENGTH - 1, row, RIGHT);
+    placeSnake(1, cols - INITIAL_LENGTH, rows - 1 - row, LEFT);
+
+    state.round++;
+    state.overTick = -1;
+    state.winner = -1;
+    spawnFood();
+}
+
+bool DuelSim::spawnFood() {
+    // Bàn nhỏ nên đếm thẳng tới ô trống thứ k, không cần danh sách ô trống như Grid
+    int freeCount = cols * rows - state.snakes[0].length - state.snakes[1].length;
+    if (freeCount <= 0) {
+        state.food = -1;
+        return false;
+    }
+
+    int skip = static_cast<int>(state.random.nextBelow(static_cast<uint32_t>(freeCount)));
+    for (int cell = 0; cell < cols * rows; cell++) {
+        if (state.cells[cell] == 0 && skip-- == 0) {
+            state.food = cell;
+            break;
+        }
+    }
+    return true;
+}
+
+void DuelSim::endRound(int winner) {
+    state.overTick = state.tick;
+    state.winner = winner;
+    if (winner >= 0) {
+        state.wins[winner]++;
+    }
+}
+
+DuelStepResult DuelSim::step(const Direction* inputs) {
+    state.tick++;
+
+    if (state.overTick >= 0) {
+        if (state.tick - state.overTick < ROUND_PAUSE_TICKS) {
+            return DUEL_STEP_NONE;
+        }
+        startRound();
+        return DUEL_STEP_ROUND_START;
+    }
+
+    int newHeads[2];
+    bool grows[2];
+    int tails[2];
+    for (int i = 0; i < 2; i++) {
+        DuelSnakeState& snake = state.snakes[i];
+
+        // Như Snake::setDirection(): không quay đầu ngược lại (hướng ngược là d ^ 1)
+        if (inputs[i] != static_cast<Direction>(snake.direction ^ 1)) {
+            snake.direction = static_cast<uint8_t>(inputs[i]);
+        }
+
+        int head = snake.body[snake.head];
+        int col = head % cols + (snake.direction == RIGHT) - (snake.direction == LEFT);
+        int row = head / cols + (snake.direction == DOWN) - (snake.direction == UP);
+        newHeads[i] = (col < 0 || col >= cols || row < 0 || row >= rows) ? -1 : row * cols + col;
+        grows[i] = newHeads[i] >= 0 && newHeads[i] == state.food;
+        tails[i] = snake.body[(snake.head + snake.length - 1) & RING_MASK];
+    }
+
+    // Ô đuôi của rắn không ăn mồi được giải phóng trước khi xét va chạm
+    bool dead[2];
+    for (int i = 0; i < 2; i++) {
+        int cell = newHeads[i];
+        if (cell < 0) {
+            dead[i] = true;
+            continue;
+        }
+        int occupied = state.cells[cell];
+        for (int j = 0; j < 2; j++) {
+            if (!grows[j] && tails[j] == cell) {
+                occupied--;
+            }
+        }
+        dead[i] = occupied > 0 || newHeads[0] == newHeads[1];
+    }
+
+    // Có rắn chết thì bàn đứng yên ở trạng thái ngay trước va chạm
+    if (dead[0] || dead[1]) {
+        state.snakes[0].alive = dead[0] ? 0 : 1;
+        state.snakes[1].alive = dead[1] ? 0 : 1;
+        endRound(dead[0] && dead[1] ? -1 : (dead[0] ? 1 : 0));
+        return DUEL_STEP_ROUND_OVER;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        DuelSnakeState& snake = state.snakes[i];
+        snake.lastTail = static_cast<uint16_t>(tails[i]);
+        if (grows[i]) {
+            snake.score += GameSim::FOOD_SCORE;
+        } else {
+            state.cells[tails[i]] = 0;
+            snake.length--;
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        DuelSnakeState& snake = state.snakes[i];
+        snake.head = static_cast<uint16_t>((snake.head + RING_MASK) & RING_MASK);
+        snake.body[snake.head] = static_cast<uint16_t>(newHeads[i]);
+        snake.length++;
+        state.cells[newHeads[i]] = 1;
+    }
+
+    if (!grows[0] && !grows[1]) {
+        return DUEL_STEP_NONE;
+    }
+    if (!spawnFood()) {
+        // Bàn đã đầy: ai nhiều điểm hơn thắng
+        int first = state.snakes[0].score;
+        int second = state.snakes[1].score;
+        endRound(first == second ? -1 : (first > second ? 0 : 1));
+        return DUEL_STEP_ROUND_OVER;
+    }
+    return DUEL_STEP_ATE;
+}
+
+uint64_t DuelSim::getStateHash() const {
+    uint64_t hash = FNV_OFFSET;
+    hash = hashInt(hash, state.tick);
+    hash = hashInt(hash, state.round);
+    hash = hashInt(hash, state.overTick);
+    hash = hashInt(hash, state.wins[0]);
+    hash = hashInt(hash, state.wins[1]);
+    hash = hashInt(hash, state.food);
+
+    for (int i = 0; i < 2; i++) {
+        const DuelSnakeState& snake = state.snakes[i];
+        hash = hashInt(hash, snake.direction);
+        hash = hashInt(hash, snake.alive);
+        hash = hashInt(hash, snake.score);
+        hash = hashInt(hash, snake.length);
+        for (int j = 0; j < snake.length; j++) {
+            hash = hashInt(hash, getSegment(i, j));
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,97 @@
+#ifndef DUELSIM_H
+#define DUELSIM_H
+
+#include <cstdint>
+
+#include "GameSim.h"
+#include "Random.h"
+
+// Bàn đấu tay đôi lớn nhất: vừa một màn hình 32x24 ô, và là lũy thừa của 2
+// để bộ đệm vòng của thân rắn chỉ cần phép AND
+const int DUEL_MAX_CELLS = 1024;
+
+// Kết quả của một bước đấu tay đôi
+enum DuelStepResult {
+    DUEL_STEP_NONE,
+    DUEL_STEP_ATE,          // Có rắn ăn mồi
+    DUEL_STEP_ROUND_OVER,   // Có rắn chết hoặc bàn đã đầy
+    DUEL_STEP_ROUND_START   // Hết thời gian nghỉ, bắt đầu ván mới
+};
+
+// Một rắn trong trận đấu, tọa độ theo ô (chỉ số row * cols + col)
+struct DuelSnakeState {
+    uint16_t body[DUEL_MAX_CELLS];  // Bộ đệm vòng, đoạn i nằm ở body[(head + i) & (DUEL_MAX_CELLS - 1)]
+    uint16_t head;
+    uint16_t length;
+    uint16_t lastTail;              // Ô đuôi vừa rời ở bước gần nhất (để nội suy khi vẽ)
+    uint8_t direction;
+    uint8_t alive;
+    int32_t score;
+};
+
+// Toàn bộ trạng thái trận đấu, kể cả bộ sinh số ngẫu nhiên của mồi: không có con trỏ
+// hay vùng nhớ cấp phát nên lưu/khôi phục chỉ là một lần chép ~5 KB.
+struct DuelState {
+    int32_t tick;
+    int32_t round;
+    int32_t overTick;               // Bước kết thúc ván hiện tại, -1 nếu đang chơi
+    int32_t winner;                 // Của ván vừa kết thúc: 0, 1, hoặc -1 nếu hòa
+    int32_t wins[2];
+    int32_t food;                   // Ô có mồi, -1 nếu không còn chỗ
+    Random random;
+    DuelSnakeState snakes[2];
+    uint8_t cells[DUEL_MAX_CELLS];  // 1 nếu ô có đoạn thân rắn
+};
+
+// Đấu tay đôi hai rắn trên một bàn nhỏ, không phụ thuộc SDL, dành cho chơi qua mạng
+// với rollback: cùng trạng thái và cùng hướng đi của hai bên thì cho cùng kết quả
+// trên mọi máy.
+//
+// Luật như GameSim, hai rắn di chuyển đồng thời. Rắn có đầu mới vào ô mồi thì giữ
+// đuôi, các rắn khác rời ô đuôi trước, rồi mỗi đầu mới được xét với phần thân còn
+// lại. Đâm tường, thân (của mình hay đối thủ) hoặc hai đầu vào cùng một ô đều chết;
+// cả hai cùng chết là hòa. Ván kết thúc thì bàn đứng yên ROUND_PAUSE_TICKS bước rồi
+// tự bắt đầu ván mới, nên hai máy không cần trao đổi gì thêm ngoài hướng đi.
+class DuelSim {
+private:
+    int cols;
+    int rows;
+    DuelState state;
+
+    void startRound();
+    void placeSnake(int index, int col, int row, Direction direction);
+    bool spawnFood();
+    void endRound(int winner);
+
+public:
+    static const int INITIAL_LENGTH = 3;
+    static const int ROUND_PAUSE_TICKS = 20;
+    static const int TICK_MS = 100;         // Nhịp cố định: hai máy phải cùng đếm bước
+
+    // cols >= 8, rows >= 1, cols * rows <= DUEL_MAX_CELLS
+    DuelSim(int cols, int rows);
+
+    void reset(unsigned int seed);
+    // inputs[i] là hướng mới của rắn i (quay đầu ngược lại bị bỏ qua như Snake)
+    DuelStepResult step(const Direction* inputs);
+
+    void save(DuelState& out) const { out = state; }
+    void restore(const DuelState& in) { state = in; }
+    const DuelState& getState() const { return state; }
+
+    // Đoạn thứ i của rắn (0 là đầu), trả về chỉ số ô
+    int getSegment(int index, int i) const {
+        const DuelSnakeState& snake = state.snakes[index];
+        return snake.body[(snake.head + i) & (DUEL_MAX_CELLS - 1)];
+    }
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    int getTick() const { return state.tick; }
+    bool isRoundOver() const { return state.overTick >= 0; }
+
+    // Băm FNV-1a các phần có nghĩa của trạng thái, để hai máy phát hiện lệch nhau
+    uint64_t getStateHash() const;
+};
+
+#endif // DUELSIM_H
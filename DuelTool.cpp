@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DuelSession.h"
+
+// snake_duel: chạy hai đầu của một trận đấu tay đôi trên loopback, có giả lập độ trễ
+// và mất gói, để kiểm tra rollback. Mỗi bên do một bot điều khiển (có lúc rẽ ngẫu nhiên
+// để đối thủ đoán sai). Cuối cùng mô phỏng lại cả trận từ seed với các hướng đi đã xác
+// nhận và so mã băm với hai bên.
+//
+//   snake_duel [--ticks 600] [--tick-ms 100] [--latency 60] [--jitter 10] [--loss 0.05]
+//              [--cols 32] [--rows 24]
+
+namespace {
+
+struct Options {
+    int ticks;
+    int tickMs;
+    int latency;
+    int jitter;
+    double loss;
+    int cols;
+    int rows;
+    bool help;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Cách dùng: snake_duel [--ticks 600] [--tick-ms 100] [--latency 60] [--jitter 10] [--loss 0.05]\n"
+        << "                  [--cols 32] [--rows 24]" << std::endl;
+}
+
+bool parseOptions(int argc, char* args[], Options& options) {
+    options.ticks = 600;
+    options.tickMs = DuelSim::TICK_MS;
+    options.latency = 60;
+    options.jitter = 10;
+    options.loss = 0.05;
+    options.cols = 32;
+    options.rows = 24;
+    options.help = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            options.help = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Thiếu giá trị cho " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = args[++i];
+        if (arg == "--ticks") {
+            options.ticks = atoi(value.c_str());
+        } else if (arg == "--tick-ms") {
+            options.tickMs = atoi(value.c_str());
+        } else if (arg == "--latency") {
+            options.latency = atoi(value.c_str());
+        } else if (arg == "--jitter") {
+            options.jitter = atoi(value.c_str());
+        } else if (arg == "--loss") {
+            options.loss = atof(value.c_str());
+        } else if (arg == "--cols") {
+            options.cols = atoi(value.c_str());
+        } else if (arg == "--rows") {
+            options.rows = atoi(value.c_str());
+        } else {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.ticks > 0 && options.tickMs > 0 && options.loss >= 0 && options.loss < 1 &&
+           options.cols >= 8 && options.rows >= 1 && options.cols * options.rows <= DUEL_MAX_CELLS;
+}
+
+// Đi về phía mồi, tránh tường và thân rắn; thỉnh thoảng chọn ngẫu nhiên một hướng an toàn
+Direction decideBot(const DuelSim& sim, int index, Random& random) {
+    const DuelState& state = sim.getState();
+    int cols = sim.getCols();
+    int head = sim.getSegment(index, 0);
+    int headCol = head % cols;
+    int headRow = head / cols;
+    Direction current = static_cast<Direction>(state.snakes[index].direction);
+
+    Direction safe[4];
+    int safeCount = 0;
+    Direction best = current;
+    int bestDistance = -1;
+    for (int d = UP; d <= RIGHT; d++) {
+        Direction dir = static_cast<Direction>(d);
+        int col = headCol + (dir == RIGHT) - (dir == LEFT);
+        int row = headRow + (dir == DOWN) - (dir == UP);
+        if (dir == (current ^ 1) || col < 0 || col >= cols || row < 0 || row >= sim.getRows() ||
+            state.cells[row * cols + col] != 0) {
+            continue;
+        }
+        safe[safeCount++] = dir;
+        if (state.food >= 0) {
+            int distance = abs(col - state.food % cols) + abs(row - state.food / cols);
+            if (bestDistance < 0 || distance < bestDistance) {
+                bestDistance = distance;
+                best = dir;
+            }
+        }
+    }
+
+    if (safeCount > 0 && (bestDistance < 0 || random.nextBelow(100) < 15)) {
+        return safe[random.nextBelow(safeCount)];
+    }
+    return best;
+}
+
+// Bên thứ i của trận: phiên mạng, bot và mốc bước kế tiếp theo đồng hồ của nó
+struct Peer {
+    std::unique_ptr<DuelSession> session;
+    Random random;
+    std::chrono::steady_clock::time_point nextTick;
+    bool running;
+};
+
+}
+
+int main(int argc, char* args[]) {
+    Options options;
+    if (!parseOptions(argc, args, options)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(std::cout);
+        return 0;
+    }
+
+    Peer peers[2];
+    for (int i = 0; i < 2; i++) {
+        peers[i].session.reset(new DuelSession(options.cols, options.rows));
+        peers[i].session->setLinkConditions(options.latency, options.jitter, options.loss);
+        peers[i].random.seed(1000 + i);
+        peers[i].running = false;
+    }
+    if (!peers[0].session->host(0) || !peers[1].session->join("127.0.0.1", peers[0].session->getPort())) {
+        return 1;
+    }
+
+    std::cout << "snake_duel: " << options.ticks << " bước x " << options.tickMs << " ms, độ trễ "
+              << options.latency << " ± " << options.jitter << " ms mỗi chiều, mất " << options.loss * 100
+              << "% gói" << std::endl;
+
+    // Hướng đi đã xác nhận của cả hai người chơi, để mô phỏng lại cả trận ở cuối
+    std::vector<Direction> inputs[2];
+    const std::chrono::milliseconds tickLength(options.tickMs);
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + tickLength * (options.ticks * 4) + std::chrono::seconds(5);
+
+    while (std::min(peers[0].session->getSim().getTick(), peers[1].session->getSim().getTick()) < options.ticks) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now > deadline) {
+            std::cerr << "Hết giờ: hai bên không chạy được đủ số bước" << std::endl;
+            return 1;
+        }
+
+        for (int i = 0; i < 2; i++) {
+            Peer& peer = peers[i];
+            DuelSession& session = *peer.session;
+            session.poll();
+            if (!peer.running && session.isStarted()) {
+                peer.running = true;
+                peer.nextTick = now;
+            }
+
+            // Như Game::update(): mỗi nhịp gọi advance() một lần, dù có phải chờ hay không
+            if (peer.running && now >= peer.nextTick && session.getSim().getTick() < options.ticks) {
+                session.advance(decideBot(session.getSim(), session.getPlayerIndex(), peer.random));
+                peer.nextTick += tickLength;
+            }
+        }
+
+        // Chép các hướng đi vừa được xác nhận trước khi chúng ra khỏi lịch sử
+        const DuelSession& host = *peers[0].session;
+        int confirmed = std::min(host.getConfirmedTick(), host.getSim().getTick() - 1);
+        for (int t = static_cast<int>(inputs[0].size()); t <= confirmed; t++) {
+            inputs[0].push_back(host.getInput(0, t));
+            inputs[1].push_back(host.getInput(1, t));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Chờ xác nhận nốt những bước cuối (cả hai bên vẫn gửi gói khi đứng chờ)
+    while (static_cast<int>(inputs[0].size()) < options.ticks && std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 2; i++) {
+            peers[i].session->poll();
+        }
+        const DuelSession& host = *peers[0].session;
+        int confirmed = std::min(host.getConfirmedTick(), host.getSim().getTick() - 1);
+        for (int t = static_cast<int>(inputs[0].size()); t <= confirmed; t++) {
+            inputs[0].push_back(host.getInput(0, t));
+            inputs[1].push_back(host.getInput(1, t));
+        }
+        // Gửi lại hướng đi của bước cuối phòng khi gói trước bị mất
+        peers[0].session->advance(RIGHT);
+        peers[1].session->advance(LEFT);
+        std::this_thread::sleep_for(tickLength);
+    }
+
+    // Mô phỏng lại không qua mạng: phải ra đúng trạng thái mà hai bên đã xác nhận
+    DuelSim replay(options.cols, options.rows);
+    replay.reset(peers[0].session->getSeed());
+    for (size_t t = 0; t < inputs[0].size(); t++) {
+        Direction both[2] = {inputs[0][t], inputs[1][t]};
+        replay.step(both);
+    }
+    int lastTick = static_cast<int>(inputs[0].size()) - 1;
+    bool matches = lastTick >= 0 && replay.getStateHash() == peers[0].session->getHash(lastTick);
+    const DuelSession& guest = *peers[1].session;
+    if (matches && guest.getConfirmedTick() >= lastTick && guest.getSim().getTick() - lastTick <= DuelSession::MAX_ROLLBACK) {
+        matches = replay.getStateHash() == guest.getHash(lastTick);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        const DuelSession& session = *peers[i].session;
+        const DuelStats& stats = session.getStats();
+        std::cout << "  người chơi " << i << ": " << stats.ticks << " bước, " << stats.rollbacks << " lần rollback ("
+                  << (stats.rollbacks > 0 ? static_cast<double>(stats.resimulatedTicks) / stats.rollbacks : 0)
+                  << " bước tb, tối đa " << stats.maxRollback << ", lâu nhất " << stats.maxResimMicros << " us), "
+                  << stats.stalls << " lần chờ, RTT " << stats.rttMs << " ms, " << stats.packetsDropped << "/"
+                  << stats.packetsSent << " gói bị bỏ, đã so mã băm tới bước " << session.getCheckedTick() << std::endl;
+        if (session.isDesynced()) {
+            std::cerr << "  người chơi " << i << " lệch trạng thái ở bước " << session.getDesyncTick() << std::endl;
+            matches = false;
+        }
+    }
+
+    const DuelState& state = replay.getState();
+    std::cout << "  " << inputs[0].size() << " bước đã xác nhận, " << state.round << " ván, tỉ số "
+              << state.wins[0] << " - " << state.wins[1] << ": "
+              << (matches ? "mô phỏng lại khớp với cả hai bên" : "KHÔNG khớp") << std::endl;
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "EnvClient.h"
+#include "SnakeEnv.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const int WAIT_TIMEOUT_MS = 100; // Thức dậy định kỳ để kiểm tra máy chủ còn chạy
+
+}
+
+EnvClient::EnvClient()
+    : fd(-1), memory(nullptr), size(0), header(nullptr), submitted(0), completed(0), latest(0), spins(defaultEnvSpinCount()) {
+}
+
+EnvClient::~EnvClient() {
+    disconnect();
+}
+
+bool EnvClient::connect(const std::string& name, int timeoutMs) {
+    disconnect();
+
+    // Máy chủ có thể chưa khởi động xong: đợi vùng nhớ có đủ header và magic
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd >= 0) {
+            struct stat info;
+            if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= envShmHeaderBytes()) {
+                void* mapped = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    memory = static_cast<unsigned char*>(mapped);
+                    size = info.st_size;
+                    header = reinterpret_cast<EnvShmHeader*>(memory);
+                    if (header->magic.load(std::memory_order_acquire) == ENV_SHM_MAGIC) {
+                        break;
+                    }
+                    munmap(memory, size);
+                    memory = nullptr;
+                    header = nullptr;
+                }
+            }
+            ::close(fd);
+            fd = -1;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "Không kết nối được tới " << name << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (header->version != ENV_SHM_VERSION ||
+        size < envShmHeaderBytes() + header->slotBytes * static_cast<size_t>(header->slotCount)) {
+        std::cerr << "Vùng nhớ " << name << " không đúng phiên bản hoặc kích thước" << std::endl;
+        disconnect();
+        return false;
+    }
+
+    // Tiếp tục từ chỗ client trước (nếu có) đã dừng
+    completed = header->responses.sequence.load(std::memory_order_acquire);
+    submitted = header->requests.sequence.load(std::memory_order_acquire);
+    latest = completed - 1;
+    return true;
+}
+
+void EnvClient::disconnect() {
+    if (memory != nullptr) {
+        munmap(memory, size);
+        memory = nullptr;
+        size = 0;
+        header = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+int32_t* EnvClient::nextActions() {
+    // Vòng đầy: slot sắp ghi vẫn thuộc một yêu cầu máy chủ chưa xử lý xong
+    if (submitted - completed >= static_cast<uint32_t>(header->slotCount) && !wait(submitted - header->slotCount)) {
+        return nullptr;
+    }
+    return reinterpret_cast<int32_t*>(slot(submitted) + header->actionsOffset);
+}
+
+long long EnvClient::submit(EnvCommand command, uint32_t seed) {
+    if (nextActions() == nullptr) {
+        return -1;
+    }
+
+    EnvSlotHeader* request = reinterpret_cast<EnvSlotHeader*>(slot(submitted));
+    request->command = command;
+    request->seed = seed;
+    request->status = SNAKE_ENV_OK;
+
+    uint32_t sequence = submitted++;
+    header->requests.ring(submitted);
+    return sequence;
+}
+
+bool EnvClient::wait(uint32_t sequence) {
+    // So sánh theo hiệu để đúng cả khi bộ đếm quay vòng
+    completed = header->responses.sequence.load(std::memory_order_acquire);
+    while (static_cast<int32_t>(completed - sequence) <= 0) {
+        if (header->closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+        completed = header->responses.wait(completed, spins, WAIT_TIMEOUT_MS);
+    }
+    return true;
+}
+
+int EnvClient::step() {
+    long long sequence = submit(ENV_COMMAND_STEP);
+    if (sequence < 0 || !wait(static_cast<uint32_t>(sequence))) {
+        return SNAKE_ENV_ERROR_UNBOUND;
+    }
+    latest = static_cast<uint32_t>(sequence);
+    return getStatus(latest);
+}
+
+int EnvClient::reset(uint32_t seed) {
+    long long sequence = submit(ENV_COMMAND_RESET, seed);
+    if (sequence < 0 || !wait(static_cast<uint32_t>(sequence))) {
+        return SNAKE_ENV_ERROR_UNBOUND;
+    }
+    latest = static_cast<uint32_t>(sequence);
+    return getStatus(latest);
+}
+
+void EnvClient::shutdown() {
+    long long sequence = submit(ENV_COMMAND_CLOSE);
+    if (sequence >= 0) {
+        wait(static_cast<uint32_t>(sequence));
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,80 @@
+#ifndef ENVCLIENT_H
+#define ENVCLIENT_H
+
+#include <cstdint>
+#include <string>
+
+#include "EnvShm.h"
+
+// Thư viện phía client của snake_envd: ánh xạ vùng nhớ chung của máy chủ và gửi
+// yêu cầu qua vòng slot. Hành động ghi thẳng vào slot, kết quả đọc thẳng từ slot:
+// không tuần tự hóa, không sao chép. Chỉ dùng trên Linux.
+//
+//   EnvClient client;
+//   client.connect("/snake_env", 5000);
+//   client.reset(1);
+//   int32_t* actions = client.nextActions();   // ghi envCount hành động
+//   client.step();
+//   const float* obs = client.getObservations();
+//
+// Có thể gửi trước nhiều yêu cầu (tối đa slotCount) bằng submit() rồi wait() sau.
+class EnvClient {
+private:
+    int fd;
+    unsigned char* memory;
+    size_t size;
+    EnvShmHeader* header;
+    uint32_t submitted;   // Số yêu cầu đã gửi
+    uint32_t completed;   // Số yêu cầu máy chủ đã trả lời
+    uint32_t latest;      // Yêu cầu gần nhất đã xong mà step()/reset() trả kết quả
+    int spins;
+
+    unsigned char* slot(uint32_t sequence) const { return memory + envShmHeaderBytes() + header->slotBytes * (sequence % header->slotCount); }
+
+public:
+    EnvClient();
+    ~EnvClient();
+
+    // Đợi tối đa timeoutMs để máy chủ tạo vùng nhớ và sẵn sàng
+    bool connect(const std::string& name, int timeoutMs);
+    void disconnect();
+
+    void setSpinCount(int spins) { this->spins = spins; }
+
+    int getEnvCount() const { return header->envCount; }
+    int getCols() const { return header->cols; }
+    int getRows() const { return header->rows; }
+    int getObsType() const { return header->obsType; }
+    int getObsSize() const { return header->obsSize; }
+    int getSlotCount() const { return header->slotCount; }
+
+    // Bộ đệm hành động của yêu cầu sẽ gửi tiếp theo (vòng đầy thì đợi slot được trả),
+    // nullptr nếu máy chủ đã dừng
+    int32_t* nextActions();
+
+    // Gửi yêu cầu (vòng đầy thì đợi yêu cầu cũ nhất xong), trả về số thứ tự, hoặc -1 khi máy chủ đã dừng
+    long long submit(EnvCommand command, uint32_t seed = 0);
+    // Đợi tới khi yêu cầu sequence xong; false nếu máy chủ đã dừng
+    bool wait(uint32_t sequence);
+
+    // Gửi một yêu cầu rồi đợi kết quả; trả về mã của snake_env_step/reset
+    int step();
+    int reset(uint32_t seed);
+    // Báo máy chủ dừng
+    void shutdown();
+
+    // Kết quả của yêu cầu sequence (mặc định: yêu cầu gần nhất của step()/reset())
+    const float* getObservations(uint32_t sequence) const { return reinterpret_cast<const float*>(slot(sequence) + header->obsOffset); }
+    const float* getRewards(uint32_t sequence) const { return reinterpret_cast<const float*>(slot(sequence) + header->rewardsOffset); }
+    const uint8_t* getDones(uint32_t sequence) const { return slot(sequence) + header->donesOffset; }
+    int getStatus(uint32_t sequence) const { return reinterpret_cast<const EnvSlotHeader*>(slot(sequence))->status; }
+    const float* getObservations() const { return getObservations(latest); }
+    const float* getRewards() const { return getRewards(latest); }
+    const uint8_t* getDones() const { return getDones(latest); }
+
+    // Số lần mỗi bên phải gọi futex_wake
+    uint32_t getClientWakeups() const { return header->requests.wakeups.load(); }
+    uint32_t getServerWakeups() const { return header->responses.wakeups.load(); }
+};
+
+#endif // ENVCLIENT_H
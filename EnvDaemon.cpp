@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EnvClient.h"
+#include "EnvServer.h"
+#include "Random.h"
+
+// snake_envd: chạy N ván không cần cửa sổ và phục vụ các tiến trình huấn luyện
+// qua vùng nhớ chung POSIX (xem EnvShm.h, client dùng EnvClient).
+//
+//   snake_envd [--name /snake_env] [--envs 64] [--cols 16] [--rows 12]
+//              [--obs planes|features] [--slots 4] [--seed 1] [--spin N]
+//              [--bench STEPS]
+//
+// --bench tách tiến trình: tiến trình con làm máy chủ, tiến trình cha làm client
+// gửi STEPS bước rồi in độ trễ mỗi vòng và số lần phải đánh thức bằng futex.
+// --spin mặc định 1024 (0 trên máy một lõi).
+
+#ifdef __linux__
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) {
+    stopRequested = 1;
+}
+
+struct Options {
+    std::string name;
+    int envs;
+    int cols;
+    int rows;
+    int obsType;
+    int slots;
+    unsigned int seed;
+    int spins;
+    int benchSteps;
+    bool help;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Cách dùng: snake_envd [--name /snake_env] [--envs 64] [--cols 16] [--rows 12]\n"
+        << "                  [--obs planes|features] [--slots 4] [--seed 1] [--spin N]\n"
+        << "                  [--bench STEPS]" << std::endl;
+}
+
+bool parseOptions(int argc, char* args[], Options& options) {
+    options.name = "/snake_env";
+    options.envs = 64;
+    options.cols = 16;
+    options.rows = 12;
+    options.obsType = SNAKE_ENV_OBS_PLANES;
+    options.slots = 4;
+    options.seed = 1;
+    options.spins = defaultEnvSpinCount();
+    options.benchSteps = 0;
+    options.help = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            options.help = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Thiếu giá trị cho " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = args[++i];
+        if (arg == "--name") {
+            options.name = value;
+        } else if (arg == "--envs") {
+            options.envs = atoi(value.c_str());
+        } else if (arg == "--cols") {
+            options.cols = atoi(value.c_str());
+        } else if (arg == "--rows") {
+            options.rows = atoi(value.c_str());
+        } else if (arg == "--obs") {
+            if (value == "planes") {
+                options.obsType = SNAKE_ENV_OBS_PLANES;
+            } else if (value == "features") {
+                options.obsType = SNAKE_ENV_OBS_FEATURES;
+            } else {
+                std::cerr << "Kiểu quan sát không hợp lệ: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--slots") {
+            options.slots = atoi(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned int>(strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--spin") {
+            options.spins = atoi(value.c_str());
+        } else if (arg == "--bench") {
+            options.benchSteps = atoi(value.c_str());
+        } else {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.name.empty() || options.name[0] != '/') {
+        options.name = "/" + options.name;
+    }
+    return options.envs > 0 && options.slots > 0 && options.spins >= 0 && options.benchSteps >= 0;
+}
+
+int serve(const Options& options) {
+    EnvServer server;
+    if (!server.create(options.name, options.envs, options.cols, options.rows, options.obsType, options.slots, options.seed)) {
+        return 1;
+    }
+    server.setSpinCount(options.spins);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    std::cout << "snake_envd: " << options.name << ", " << options.envs << " ván "
+              << options.cols << "x" << options.rows << ", " << options.slots << " slot" << std::endl;
+    server.run(&stopRequested);
+    std::cout << "snake_envd: dừng sau " << server.getHandledCount() << " yêu cầu" << std::endl;
+    return 0;
+}
+
+double percentile(std::vector<double>& values, double p) {
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int bench(const Options& options) {
+    pid_t child = fork();
+    if (child < 0) {
+        std::cerr << "Không tách được tiến trình máy chủ" << std::endl;
+        return 1;
+    }
+    if (child == 0) {
+        EnvServer server;
+        if (!server.create(options.name, options.envs, options.cols, options.rows, options.obsType, options.slots, options.seed)) {
+            _exit(1);
+        }
+        server.setSpinCount(options.spins);
+        server.run(nullptr);
+        server.close();
+        _exit(0);
+    }
+
+    EnvClient client;
+    client.setSpinCount(options.spins);
+    if (!client.connect(options.name, 5000) || client.reset(options.seed) != SNAKE_ENV_OK) {
+        kill(child, SIGTERM);
+        waitpid(child, nullptr, 0);
+        return 1;
+    }
+
+    Random random(options.seed);
+    std::vector<double> latencies(options.benchSteps);
+    long long episodes = 0;
+    uint32_t clientWakeups = client.getClientWakeups();
+    uint32_t serverWakeups = client.getServerWakeups();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int step = 0; step < options.benchSteps; step++) {
+        int32_t* actions = client.nextActions();
+        for (int i = 0; i < options.envs; i++) {
+            actions[i] = static_cast<int32_t>(random.nextBelow(4));
+        }
+
+        std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+        if (client.step() != SNAKE_ENV_OK) {
+            std::cerr << "Máy chủ dừng giữa chừng" << std::endl;
+            break;
+        }
+        latencies[step] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count();
+
+        const uint8_t* dones = client.getDones();
+        for (int i = 0; i < options.envs; i++) {
+            episodes += dones[i];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    clientWakeups = client.getClientWakeups() - clientWakeups;
+    serverWakeups = client.getServerWakeups() - serverWakeups;
+
+    client.shutdown();
+    waitpid(child, nullptr, 0);
+
+    std::cout << "snake_envd bench: " << options.benchSteps << " bước x " << options.envs << " ván "
+              << options.cols << "x" << options.rows << ", " << options.slots << " slot, spin " << options.spins << std::endl;
+    std::cout << "  vòng gửi/nhận: p50 " << percentile(latencies, 0.5) << " us, p99 " << percentile(latencies, 0.99)
+              << " us, max " << *std::max_element(latencies.begin(), latencies.end()) << " us" << std::endl;
+    std::cout << "  " << options.benchSteps / seconds << " bước/s, " << options.benchSteps * static_cast<double>(options.envs) / seconds
+              << " bước ván/s, " << episodes << " ván kết thúc" << std::endl;
+    std::cout << "  futex_wake mỗi bước: client " << static_cast<double>(clientWakeups) / options.benchSteps
+              << ", máy chủ " << static_cast<double>(serverWakeups) / options.benchSteps << std::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* args[]) {
+    Options options;
+    if (!parseOptions(argc, args, options)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(std::cout);
+        return 0;
+    }
+    return options.benchSteps > 0 ? bench(options) : serve(options);
+}
+
+#else
+
+int main() {
+    std::cerr << "snake_envd cần Linux (POSIX shm và futex)" << std::endl;
+    return 1;
+}
+
+#endif // __linux__
@@ -0,0 +1,165 @@
+#include "EnvServer.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+const int WAIT_TIMEOUT_MS = 100; // Thức dậy định kỳ để kiểm tra cờ dừng
+
+}
+
+EnvServer::EnvServer()
+    : fd(-1), memory(nullptr), size(0), header(nullptr), env(nullptr), spins(defaultEnvSpinCount()), handled(0) {
+}
+
+EnvServer::~EnvServer() {
+    close();
+}
+
+bool EnvServer::create(const std::string& name, int envCount, int cols, int rows, int obsType, int slotCount, uint32_t seed) {
+    close();
+
+    if (slotCount <= 0) {
+        std::cerr << "Số slot phải lớn hơn 0" << std::endl;
+        return false;
+    }
+
+    env = snake_env_create(envCount, cols, rows, seed);
+    int obsSize = snake_env_obs_size(env, obsType);
+    if (env == nullptr || obsSize < 0) {
+        std::cerr << "Tham số môi trường không hợp lệ" << std::endl;
+        close();
+        return false;
+    }
+
+    obs.assign(static_cast<size_t>(envCount) * obsSize, 0.0f);
+    rewards.assign(envCount, 0.0f);
+    dones.assign(envCount, 0);
+    snake_env_bind(env, obsType, obs.data(), rewards.data(), dones.data());
+
+    size_t bytes = layoutEnvShm(layout, envCount, obsSize, slotCount);
+
+    // Vùng còn sót lại sau lần chạy trước bị bỏ đi
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Không tạo được vùng nhớ chung " << name << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    this->name = name;
+
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "Không cấp được " << bytes << " byte cho " << name << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Không ánh xạ được " << name << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    memory = static_cast<unsigned char*>(mapped);
+    size = bytes;
+
+    // ftruncate đã điền 0, chỉ cần dựng header
+    header = new (memory) EnvShmHeader();
+    layoutEnvShm(*header, envCount, obsSize, slotCount);
+    header->version = ENV_SHM_VERSION;
+    header->cols = cols;
+    header->rows = rows;
+    header->obsType = obsType;
+    header->closed.store(0);
+    header->requests.sequence.store(0);
+    header->requests.sleeping.store(0);
+    header->requests.wakeups.store(0);
+    header->responses.sequence.store(0);
+    header->responses.sleeping.store(0);
+    header->responses.wakeups.store(0);
+    header->magic.store(ENV_SHM_MAGIC, std::memory_order_release);
+
+    handled = 0;
+    return true;
+}
+
+void EnvServer::close() {
+    if (header != nullptr) {
+        header->closed.store(1);
+        // Client đang đợi thì đánh thức để nó thấy cờ closed
+        header->responses.ring(header->responses.sequence.load());
+        header = nullptr;
+    }
+    if (memory != nullptr) {
+        munmap(memory, size);
+        memory = nullptr;
+        size = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+        shm_unlink(name.c_str());
+    }
+    if (env != nullptr) {
+        snake_env_destroy(env);
+        env = nullptr;
+    }
+}
+
+bool EnvServer::handle(uint32_t sequence) {
+    unsigned char* data = slot(sequence);
+    EnvSlotHeader* request = reinterpret_cast<EnvSlotHeader*>(data);
+
+    switch (request->command) {
+        case ENV_COMMAND_STEP:
+            request->status = snake_env_step(env, reinterpret_cast<const int32_t*>(data + layout.actionsOffset));
+            break;
+        case ENV_COMMAND_RESET:
+            request->status = snake_env_reset(env, request->seed);
+            break;
+        case ENV_COMMAND_CLOSE:
+            request->status = SNAKE_ENV_OK;
+            return false;
+        default:
+            request->status = SNAKE_ENV_ERROR_ARGUMENT;
+            return true;
+    }
+
+    memcpy(data + layout.obsOffset, obs.data(), obs.size() * sizeof(float));
+    memcpy(data + layout.rewardsOffset, rewards.data(), rewards.size() * sizeof(float));
+    memcpy(data + layout.donesOffset, dones.data(), dones.size());
+    return true;
+}
+
+void EnvServer::run(const volatile sig_atomic_t* stop) {
+    if (header == nullptr) {
+        return;
+    }
+
+    uint32_t next = header->responses.sequence.load();
+    bool running = true;
+    while (running && !(stop != nullptr && *stop)) {
+        uint32_t requested = header->requests.wait(next, spins, WAIT_TIMEOUT_MS);
+
+        // Xử lý hết các yêu cầu đã xếp hàng rồi mới báo một lần
+        while (next != requested && running) {
+            running = handle(next);
+            next++;
+            handled++;
+        }
+        if (next != header->responses.sequence.load(std::memory_order_relaxed)) {
+            header->responses.ring(next);
+        }
+    }
+}
+
+#endif // __linux__
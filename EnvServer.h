@@ -0,0 +1,58 @@
+#ifndef ENVSERVER_H
+#define ENVSERVER_H
+
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EnvShm.h"
+#include "SnakeEnv.h"
+
+// Phía máy chủ của snake_envd: tạo vùng nhớ chung, chạy N ván bằng SnakeEnv
+// (cùng luật Direction, Snake::move()/grow() như game) và trả lời từng yêu cầu
+// trong vòng slot. Chỉ dùng trên Linux.
+class EnvServer {
+private:
+    std::string name;
+    int fd;
+    unsigned char* memory;
+    size_t size;
+    EnvShmHeader* header;
+    // Bố cục slot tính trong create(). Client ghi được vào header trong vùng nhớ chung,
+    // nên máy chủ chỉ dùng bản riêng này để tính địa chỉ, không đọc lại từ header.
+    EnvShmHeader layout;
+    SnakeEnv* env;
+    int spins;
+
+    // SnakeEnv cập nhật quan sát dạng mặt phẳng từng phần, nên giữ bản riêng
+    // rồi chép sang slot của từng yêu cầu
+    std::vector<float> obs;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+
+    long long handled;
+
+    unsigned char* slot(uint32_t sequence) const { return memory + envShmHeaderBytes() + layout.slotBytes * (sequence % layout.slotCount); }
+    // Trả về false khi nhận ENV_COMMAND_CLOSE
+    bool handle(uint32_t sequence);
+
+public:
+    EnvServer();
+    ~EnvServer();
+
+    // name là tên POSIX shm, ví dụ "/snake_env". Vùng cũ cùng tên bị thay thế.
+    bool create(const std::string& name, int envCount, int cols, int rows, int obsType, int slotCount, uint32_t seed);
+    void close();
+
+    // Số vòng quay chờ trước khi ngủ bằng futex
+    void setSpinCount(int spins) { this->spins = spins; }
+
+    // Phục vụ tới khi client gửi ENV_COMMAND_CLOSE hoặc *stop khác 0
+    void run(const volatile sig_atomic_t* stop);
+
+    long long getHandledCount() const { return handled; }
+    uint32_t getWakeupCount() const { return header != nullptr ? header->responses.wakeups.load() : 0; }
+};
+
+#endif // ENVSERVER_H
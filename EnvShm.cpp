@@ -0,0 +1,82 @@
+#include "EnvShm.h"
+
+#ifdef __linux__
+
+#include <climits>
+#include <ctime>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Không dùng FUTEX_PRIVATE_FLAG: từ futex nằm trong vùng nhớ chung giữa hai tiến trình
+long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+}
+
+void EnvDoorbell::ring(uint32_t value) {
+    // seq_cst ở cả hai phía: hoặc bên nhận thấy sequence mới trước khi ngủ,
+    // hoặc bên gửi thấy cờ sleeping và đánh thức
+    sequence.store(value, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst) != 0) {
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        futex(&sequence, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+}
+
+uint32_t EnvDoorbell::wait(uint32_t seen, int spins, int timeoutMs) {
+    for (int i = 0; i < spins; i++) {
+        uint32_t value = sequence.load(std::memory_order_acquire);
+        if (value != seen) {
+            return value;
+        }
+        cpuRelax();
+    }
+
+    sleeping.store(1, std::memory_order_seq_cst);
+    if (sequence.load(std::memory_order_seq_cst) == seen) {
+        // futex tự so sánh lại với seen nên không lỡ mất lần ring xảy ra ngay trước đó
+        timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+        futex(&sequence, FUTEX_WAIT, seen, &timeout);
+    }
+    sleeping.store(0, std::memory_order_relaxed);
+    return sequence.load(std::memory_order_acquire);
+}
+
+int defaultEnvSpinCount() {
+    return std::thread::hardware_concurrency() > 1 ? 1024 : 0;
+}
+
+size_t layoutEnvShm(EnvShmHeader& header, int envCount, int obsSize, int slotCount) {
+    size_t offset = alignShm(sizeof(EnvSlotHeader));
+    header.actionsOffset = offset;
+    offset = alignShm(offset + sizeof(int32_t) * envCount);
+    header.obsOffset = offset;
+    offset = alignShm(offset + sizeof(float) * static_cast<size_t>(envCount) * obsSize);
+    header.rewardsOffset = offset;
+    offset = alignShm(offset + sizeof(float) * envCount);
+    header.donesOffset = offset;
+    offset = alignShm(offset + sizeof(uint8_t) * envCount);
+
+    header.envCount = envCount;
+    header.obsSize = obsSize;
+    header.slotCount = slotCount;
+    header.slotBytes = offset;
+    return envShmHeaderBytes() + offset * slotCount;
+}
+
+#endif // __linux__
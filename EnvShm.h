@@ -0,0 +1,86 @@
+#ifndef ENVSHM_H
+#define ENVSHM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bố cục vùng nhớ chung (POSIX shm) giữa snake_envd và các tiến trình huấn luyện.
+// Chỉ dùng trên Linux (futex).
+//
+//   [EnvShmHeader][slot 0][slot 1]...[slot slotCount - 1]
+//
+// Mỗi slot là một yêu cầu: EnvSlotHeader, rồi actions (int32 * envCount),
+// obs (float * envCount * obsSize), rewards (float * envCount), dones (uint8 * envCount),
+// mỗi mảng căn theo 64 byte. Yêu cầu thứ k dùng slot k % slotCount; client ghi hành động
+// rồi tăng requests, máy chủ chạy bước, ghi kết quả vào cùng slot rồi tăng responses.
+// Kết quả của yêu cầu k còn nguyên tới khi client gửi yêu cầu k + slotCount.
+
+const uint32_t ENV_SHM_MAGIC = 0x564E4553; // "SENV"
+const uint32_t ENV_SHM_VERSION = 1;
+const size_t ENV_SHM_ALIGN = 64;
+
+enum EnvCommand {
+    ENV_COMMAND_STEP = 0,
+    ENV_COMMAND_RESET = 1,
+    ENV_COMMAND_CLOSE = 2
+};
+
+// Chuông cửa một chiều: bên gửi tăng sequence, bên nhận quay chờ một lúc rồi ngủ
+// bằng futex. futex_wake chỉ được gọi khi bên nhận thật sự đang ngủ, nên lúc hai
+// bên đều bận mỗi bước không tốn lời gọi hệ thống nào.
+struct EnvDoorbell {
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> sleeping;
+    std::atomic<uint32_t> wakeups;  // Số lần phải gọi futex_wake, để thống kê
+
+    void ring(uint32_t value);
+    // Đợi sequence khác seen (quay spins vòng rồi ngủ tối đa timeoutMs), trả về giá trị mới nhất
+    uint32_t wait(uint32_t seen, int spins, int timeoutMs);
+};
+
+struct alignas(ENV_SHM_ALIGN) EnvSlotHeader {
+    int32_t command;
+    uint32_t seed;      // Cho ENV_COMMAND_RESET
+    int32_t status;     // Mã trả về của snake_env_step/reset
+};
+
+struct EnvShmHeader {
+    std::atomic<uint32_t> magic;    // Ghi sau cùng, khi máy chủ đã sẵn sàng
+    uint32_t version;
+    int32_t envCount;
+    int32_t cols;
+    int32_t rows;
+    int32_t obsType;
+    int32_t obsSize;
+    int32_t slotCount;
+    uint64_t slotBytes;
+    uint64_t actionsOffset;
+    uint64_t obsOffset;
+    uint64_t rewardsOffset;
+    uint64_t donesOffset;
+    std::atomic<uint32_t> closed;   // Máy chủ đã dừng
+
+    alignas(ENV_SHM_ALIGN) EnvDoorbell requests;   // Client -> máy chủ
+    alignas(ENV_SHM_ALIGN) EnvDoorbell responses;  // Máy chủ -> client
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+inline size_t alignShm(size_t bytes) {
+    return (bytes + ENV_SHM_ALIGN - 1) & ~(ENV_SHM_ALIGN - 1);
+}
+
+inline size_t envShmHeaderBytes() {
+    return alignShm(sizeof(EnvShmHeader));
+}
+
+// Số vòng quay chờ mặc định: trên máy một lõi quay chờ chỉ chiếm mất lượt chạy
+// của bên kia, nên ngủ ngay
+int defaultEnvSpinCount();
+
+// Điền kích thước và vị trí các mảng trong slot, trả về tổng kích thước vùng nhớ
+size_t layoutEnvShm(EnvShmHeader& header, int envCount, int obsSize, int slotCount);
+
+#endif // ENVSHM_H
@@ -1,67 +1,29 @@
 #include "Food.h"
-#include <iostream>
-#include <cstdlib>
-#include <ctime>
-#include <SDL_image.h>
-#include <SDL.h>
 
 
-
-Food::Food(SDL_Renderer* renderer, int gridSize, int screenWidth, int screenHeight)
-    : renderer(renderer), gridSize(gridSize),
-      screenWidth(screenWidth), screenHeight(screenHeight),
-      texture(nullptr) {
-    srand(static_cast<unsigned int>(time(nullptr)));
-
+Food::Food(int gridSize, int worldWidth, int worldHeight)
+    : gridSize(gridSize),
+      worldWidth(worldWidth), worldHeight(worldHeight) {
     // Khởi tạo vị trí ban đầu
     position.x = 0;
     position.y = 0;
 }
 
-Food::~Food() {
-    if (texture) {
-        SDL_DestroyTexture(texture);
-    }
+void Food::seed(unsigned int seed) {
+    random.seed(seed);
 }
 
-
-bool Food::loadTexture() {
-    SDL_Surface* foodSurface = IMG_Load("assets/food.png");
-    if (!foodSurface) {
-        std::cerr << "Không thể tải hình ảnh thức ăn! SDL_Error: " << SDL_GetError() << std::endl;
+bool Food::generate(const Snake& snake) {
+    // Chọn ngẫu nhiên một ô trong danh sách ô trống, không cần thử lại
+    const Grid& grid = snake.getGrid();
+    int freeCount = grid.getFreeCount();
+    if (freeCount == 0) {
         return false;
     }
 
-    texture = SDL_CreateTextureFromSurface(renderer, foodSurface);
-    SDL_FreeSurface(foodSurface);
-
-    if (!texture) {
-        std::cerr << "Không thể tạo texture thức ăn! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
+    int cell = grid.getFreeCell(static_cast<int>(random.nextBelow(freeCount)));
+    position.x = (cell % grid.getCols()) * gridSize;
+    position.y = (cell / grid.getCols()) * gridSize;
 
     return true;
 }
-
-void Food::generate(std::vector<SnakeSegment>& snakeSegments) {
-    bool validPosition = false;
-
-    while (!validPosition) {
-        position.x = (rand() % (screenWidth / gridSize)) * gridSize;
-        position.y = (rand() % (screenHeight / gridSize)) * gridSize;
-
-        // Kiểm tra xem mồi có trùng với vị trí rắn không
-        validPosition = true;
-        for (const auto& segment : snakeSegments) {
-            if (segment.x == position.x && segment.y == position.y) {
-                validPosition = false;
-                break;
-            }
-        }
-    }
-}
-
-void Food::render() {
-    SDL_Rect destRect = {position.x, position.y, gridSize, gridSize};
-    SDL_RenderCopy(renderer, texture, nullptr, &destRect);
-}
@@ -1,30 +1,27 @@
 #ifndef FOOD_H
 #define FOOD_H
 
-#include <SDL.h>
-#include <vector>
 #include "Snake.h"
-
-using namespace std;
+#include "Random.h"
 
 class Food {
 private:
-    SDL_Point position;
-    SDL_Texture* texture;
-    SDL_Renderer* renderer;
+    Point position;
+    Random random;
     int gridSize;
-    int screenWidth;
-    int screenHeight;
+    int worldWidth;
+    int worldHeight;
 
 public:
-    Food(SDL_Renderer* renderer, int gridSize, int screenWidth, int screenHeight);
-    ~Food();
+    Food(int gridSize, int worldWidth, int worldHeight);
+
+    // Mỗi Food có dãy ngẫu nhiên riêng để ván chơi có thể lặp lại theo seed
+    void seed(unsigned int seed);
 
-    bool loadTexture();
-    void generate(vector<SnakeSegment>& snakeSegment);
-    void render();
+    // Trả về false nếu không còn ô trống nào (rắn đã phủ kín bàn chơi)
+    bool generate(const Snake& snake);
 
-    SDL_Point getPosition() {return position;}
+    Point getPosition() const {return position;}
 };
 
 #endif // FOOD_H
@@ -1,18 +1,47 @@
 #include "Game.h"
+#include "Profiler.h"
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <cstdio>
+#include <ctime>
 #include <SDL_ttf.h>
 
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
 Game::Game()
-    : window(nullptr), renderer(nullptr), backgroundTexture(nullptr),
+    : window(nullptr), renderer(nullptr), looseAssets(false),
+      loader(&assets), mediaReady(false),
+      backgroundJob(-1), headJob(-1), bodyJob(-1), foodJob(-1), eatJob(-1), crashJob(-1),
+      startCounter(0), firstFrameTraced(false),
+      backgroundSprite(-1), bodySprite(-1), foodSprite(-1),
+      drawCalls(0), showStats(false), showProfile(false),
+      incremental(false), forceSoftware(false), canvas(nullptr),
+      canvasValid(false), screenDirty(true), keepsFrame(false), screenValid(false), hudDirty(true),
       eatSound(nullptr), crashSound(nullptr),
-      snake(nullptr, GRID_SIZE), food(nullptr, GRID_SIZE, SCREEN_WIDTH, SCREEN_HEIGHT),
-      menu(nullptr), gameState(MENU_STATE), running(false), score(0), highScore(0),
-      lastUpdateTime(0), gameSpeed(150), speedIncrement(5),
-      scoreTexture(nullptr) {
+      sim(GRID_SIZE, SCREEN_WIDTH, SCREEN_HEIGHT),
+      menu(nullptr, nullptr, nullptr), cameraX(0), cameraY(0),
+      autopilotOn(false), arenaBots(0), playerDirection(RIGHT),
+      duelHost(false), duelPort(-1), netLatency(0), netJitter(0), netLoss(0), duelRound(0),
+      gameState(MENU_STATE), running(false), highScore(0),
+      frameCap(FRAME_CAP_60), lastCounter(0), accumulator(0),
+      renderAlpha(0), hasPreviousTick(false),
+      recording(false), playback(false), playbackPaused(false), playbackSpeed(1),
+      scoreFont(0) {
+    scoreText[0] = '\0';
 }
 
 Game::~Game() {
+    // Các luồng tải có thể vẫn đang chạy nếu thoát sớm; kết quả chưa dùng
+    // phải được giải phóng trước khi đóng SDL_mixer và SDL
+    loader.release();
+
+    // Ván đang chơi dở khi thoát vẫn được lưu
+    saveReplay();
+
     // Giải phóng tài nguyên âm thanh
     if (eatSound) {
         Mix_FreeChunk(eatSound);
@@ -21,12 +50,11 @@ Game::~Game() {
         Mix_FreeChunk(crashSound);
     }
 
-    // Giải phóng tài nguyên SDL
-    if (scoreTexture) {
-        SDL_DestroyTexture(scoreTexture);
-    }
-    if (backgroundTexture) {
-        SDL_DestroyTexture(backgroundTexture);
+    // Giải phóng tài nguyên SDL, các texture phải đi trước renderer
+    sprites.release();
+    text.release();
+    if (canvas) {
+        SDL_DestroyTexture(canvas);
     }
     if (renderer) {
         SDL_DestroyRenderer(renderer);
@@ -43,6 +71,8 @@ Game::~Game() {
 }
 
 bool Game::init() {
+    startCounter = SDL_GetPerformanceCounter();
+
     // Khởi tạo SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL không thể khởi tạo! SDL_Error: " << SDL_GetError() << std::endl;
@@ -68,6 +98,52 @@ bool Game::init() {
         return false;
     }
 
+    traceStartup("khởi tạo SDL");
+
+    // Replay mang theo kích thước bàn chơi của nó
+    if (playback) {
+        if (!replay.load(replayFile.c_str())) {
+            std::cerr << "Không thể đọc replay " << replayFile << std::endl;
+            return false;
+        }
+        if (replay.getGridSize() != GRID_SIZE) {
+            std::cerr << "Replay " << replayFile << " dùng cỡ ô khác" << std::endl;
+            return false;
+        }
+        setWorldSize(replay.getWorldWidth() / GRID_SIZE, replay.getWorldHeight() / GRID_SIZE);
+    }
+
+    if (arenaBots > 0) {
+        if (playback) {
+            std::cerr << "Không thể xem replay trong chế độ đấu trường" << std::endl;
+            return false;
+        }
+        // Mỗi rắn trung bình hai mồi
+        arena.reset(new ArenaSim(sim.getWorldWidth() / GRID_SIZE, sim.getWorldHeight() / GRID_SIZE,
+                                 arenaBots + 1, (arenaBots + 1) * 2));
+        arenaActions.resize(arenaBots + 1);
+    }
+
+    if (duelPort >= 0) {
+        int cols = sim.getWorldWidth() / GRID_SIZE;
+        int rows = sim.getWorldHeight() / GRID_SIZE;
+        if (playback || arena || cols < 8 || cols * rows > DUEL_MAX_CELLS) {
+            std::cerr << "Đấu tay đôi cần bàn chơi từ 8 cột tới " << DUEL_MAX_CELLS
+                      << " ô, không dùng cùng replay hay đấu trường" << std::endl;
+            return false;
+        }
+        duel.reset(new DuelSession(cols, rows));
+        duel->setLinkConditions(netLatency, netJitter, netLoss);
+        if (duelHost ? !duel->host(duelPort) : !duel->join(duelAddress, duelPort)) {
+            return false;
+        }
+        if (duelHost) {
+            std::cout << "Đấu tay đôi: chờ đối thủ ở cổng " << duel->getPort() << std::endl;
+        }
+        duelGrid.resize(cols, rows);
+        updateDuelGrid();
+    }
+
     // Tạo cửa sổ
     window = SDL_CreateWindow("Game Rắn Săn Mồi", SDL_WINDOWPOS_UNDEFINED,
                              SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH,
@@ -78,34 +154,71 @@ bool Game::init() {
     }
 
     // Tạo renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 rendererFlags = forceSoftware ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+    if (frameCap == FRAME_CAP_VSYNC) {
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (renderer == nullptr) {
         std::cerr << "Không thể tạo renderer! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    // Truyền renderer vào đối tượng rắn và thức ăn
-    snake = Snake(renderer, GRID_SIZE);
-    food = Food(renderer, GRID_SIZE, SCREEN_WIDTH, SCREEN_HEIGHT);
-    menu = Menu(renderer);
+    // Renderer phần mềm vẽ lại cả màn hình rất tốn CPU, nên chỉ vẽ phần thay đổi.
+    // Nó vẽ thẳng lên surface của cửa sổ nên khung hình cũ còn nguyên sau present.
+    SDL_RendererInfo rendererInfo;
+    if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_SOFTWARE)) {
+        incremental = true;
+        keepsFrame = true;
+    }
 
-    // Tải các tài nguyên
-    if (!loadMedia()) {
-        return false;
+    // Khi camera cuộn thì mọi ô đều đổi mỗi bước, vẽ tăng dần không còn lợi gì
+    if (incremental && (arena || duel || sim.getWorldWidth() != SCREEN_WIDTH || sim.getWorldHeight() != SCREEN_HEIGHT)) {
+        std::cerr << "Bàn chơi khác kích thước cửa sổ hoặc là đấu trường, tắt chế độ vẽ tăng dần" << std::endl;
+        incremental = false;
+    }
+
+    if (incremental) {
+        canvas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                   SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!canvas) {
+            std::cerr << "Không thể tạo canvas, tắt chế độ vẽ tăng dần! SDL_Error: " << SDL_GetError() << std::endl;
+            incremental = false;
+        }
+    }
+
+    traceStartup("cửa sổ và renderer");
+
+    // Truyền renderer, atlas chữ và nguồn tài nguyên vào menu
+    menu = Menu(renderer, &text, &assets);
+    scoreFont = text.addFont(20);
+
+    if (!looseAssets && !assets.open("assets/assets.pak")) {
+        std::cerr << "Không có assets/assets.pak, đọc các tệp rời trong assets/" << std::endl;
     }
 
-    // Khởi tạo menu
+    // Bắt đầu giải mã tài nguyên màn chơi song song, không chờ
+    queueMedia();
+    loader.start();
+    traceStartup(assets.isOpen() ? "bắt đầu tải (assets.pak)" : "bắt đầu tải (tệp rời)");
+
+    // Khởi tạo menu (đăng ký cỡ chữ của menu vào atlas)
     if (!menu.init()) {
         std::cerr << "Không thể khởi tạo menu!" << std::endl;
         return false;
     }
 
+    // Raster hóa mọi cỡ chữ một lần vào atlas; menu cần chữ ngay khung hình đầu
+    if (!text.build(renderer, assets, "font.ttf")) {
+        std::cerr << "Không thể tạo atlas chữ!" << std::endl;
+        return false;
+    }
+    traceStartup("font và menu");
+
     // Khởi tạo game
-    snake.init(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
-    food.generate(snake.getSegments());
+    sim.reset(static_cast<unsigned int>(time(nullptr)));
 
     running = true;
-    score = 0;
     updateScore();
 
     // Bắt đầu với màn hình menu
@@ -113,91 +226,187 @@ bool Game::init() {
     menu.setState(MENU_STATE);
     menu.createMainMenu();
 
+    if (playback) {
+        // Vào thẳng màn chơi, bỏ qua menu
+        reset();
+    }
+
     return true;
 }
 
-bool Game::loadMedia() {
-    // Tải hình ảnh nền
-    SDL_Surface* backgroundSurface = IMG_Load("assets/background.png");
-    if (!backgroundSurface) {
-        std::cerr << "Không thể tải hình ảnh nền! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
+void Game::traceStartup(const char* stage) {
+    double ms = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    std::cout << "[khởi động] " << stage << ": " << ms << " ms" << std::endl;
+}
 
-    backgroundTexture = SDL_CreateTextureFromSurface(renderer, backgroundSurface);
-    SDL_FreeSurface(backgroundSurface);
+void Game::queueMedia() {
+    backgroundJob = loader.addImage("background.png");
+    headJob = loader.addImage("snake_head.png");
+    bodyJob = loader.addImage("snake_body.png");
+    foodJob = loader.addImage("food.png");
+    eatJob = loader.addSound("eat.wav");
+    crashJob = loader.addSound("crash.wav");
+}
 
-    if (!backgroundTexture) {
-        std::cerr << "Không thể tạo texture nền! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
+int Game::takeSprite(int job, const char* name) {
+    SDL_Surface* surface = loader.takeSurface(job);
+    if (!surface) {
+        std::cerr << "Không thể tải hình ảnh " << name << "! SDL_Error: " << loader.getError(job) << std::endl;
+        return -1;
     }
 
-    // Tải âm thanh
-    eatSound = Mix_LoadWAV("assets/eat.wav");
+    int sprite = sprites.addSprite(surface);
+    SDL_FreeSurface(surface);
+    return sprite;
+}
+
+bool Game::finishMedia() {
+    PROFILE_SCOPE("finishMedia");
+    // Mọi việc giải mã đã xong; phần còn lại phải chạy trên luồng vẽ
+    loader.wait();
+    mediaReady = true;
+    menu.setLoadingProgress(loader.getTotal(), loader.getTotal());
+    screenDirty = true;
+
+    // Âm thanh
+    eatSound = loader.takeSound(eatJob);
     if (!eatSound) {
-        std::cerr << "Không thể tải âm thanh ăn mồi! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        std::cerr << "Không thể tải âm thanh ăn mồi! SDL_mixer Error: " << loader.getError(eatJob) << std::endl;
         return false;
     }
 
-    crashSound = Mix_LoadWAV("assets/crash.wav");
+    crashSound = loader.takeSound(crashJob);
     if (!crashSound) {
-        std::cerr << "Không thể tải âm thanh va chạm! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        std::cerr << "Không thể tải âm thanh va chạm! SDL_mixer Error: " << loader.getError(crashJob) << std::endl;
         return false;
     }
 
-    // Tải các tài nguyên khác
-    if (!snake.loadTextures()) {
+    backgroundSprite = takeSprite(backgroundJob, "nền");
+    if (backgroundSprite < 0) {
         return false;
     }
 
-    if (!food.loadTexture()) {
+    // Ảnh đầu rắn quay lên, xoay sẵn cho 3 hướng còn lại
+    SDL_Surface* headSurface = loader.takeSurface(headJob);
+    if (!headSurface) {
+        std::cerr << "Không thể tải hình ảnh đầu rắn! SDL_Error: " << loader.getError(headJob) << std::endl;
         return false;
     }
+    headSprites[UP] = sprites.addSprite(headSurface, 0);
+    headSprites[RIGHT] = sprites.addSprite(headSurface, 1);
+    headSprites[DOWN] = sprites.addSprite(headSurface, 2);
+    headSprites[LEFT] = sprites.addSprite(headSurface, 3);
+    SDL_FreeSurface(headSurface);
 
+    bodySprite = takeSprite(bodyJob, "thân rắn");
+    foodSprite = takeSprite(foodJob, "thức ăn");
+    if (bodySprite < 0 || foodSprite < 0 ||
+        headSprites[UP] < 0 || headSprites[RIGHT] < 0 || headSprites[DOWN] < 0 || headSprites[LEFT] < 0) {
+        return false;
+    }
+
+    // Gộp tất cả vào atlas và tải lên GPU
+    if (!sprites.build(renderer)) {
+        return false;
+    }
+    traceStartup("tài nguyên màn chơi sẵn sàng");
+    return true;
+}
+
+void Game::pollMedia() {
+    PROFILE_SCOPE("pollMedia");
+    if (mediaReady) {
+        return;
+    }
+
+    // Cập nhật thanh tiến trình của menu; khi xong hết thì tải atlas luôn
+    int done = loader.getCompleted();
+    if (done != menu.getLoadingDone()) {
+        menu.setLoadingProgress(done, loader.getTotal());
+        screenDirty = true;
+    }
+    if (loader.isDone() && !finishMedia()) {
+        running = false;
+    }
+}
+
+bool Game::awaitMedia() {
+    // Người chơi bấm Play trước khi tải xong: chờ phần còn lại ngay tại đây
+    if (!mediaReady && !finishMedia()) {
+        running = false;
+        return false;
+    }
     return true;
 }
 
 void Game::handleEvents() {
+    PROFILE_SCOPE("handleEvents");
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_QUIT) {
             running = false;
         }
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F4) {
+            showProfile = !showProfile;
+            screenDirty = true;
+        }
 
         // Handle events based on game state
         if (gameState == MENU_STATE || gameState == PAUSE_STATE || gameState == GAME_OVER_STATE) {
             // Let menu handle events
             menu.handleEvents(e, gameState);
+            screenDirty = true;
 
             // Check if menu wants to restart the game
             if (gameState == GAME_STATE && menu.getCurrentState() != GAME_STATE) {
                 reset();
             }
         }
+        else if (gameState == GAME_STATE && playback) {
+            if (e.type == SDL_KEYDOWN) {
+                handlePlaybackKey(e.key.keysym.sym);
+            }
+        }
         else if (gameState == GAME_STATE) {
             // In-game controls
             if (e.type == SDL_KEYDOWN) {
                 switch (e.key.keysym.sym) {
                     case SDLK_UP:
-                        snake.setDirection(UP);
+                        queueTurn(UP);
                         break;
                     case SDLK_DOWN:
-                        snake.setDirection(DOWN);
+                        queueTurn(DOWN);
                         break;
                     case SDLK_LEFT:
-                        snake.setDirection(LEFT);
+                        queueTurn(LEFT);
                         break;
                     case SDLK_RIGHT:
-                        snake.setDirection(RIGHT);
+                        queueTurn(RIGHT);
                         break;
                     case SDLK_ESCAPE:
                         // Pause the game
+                        inputQueue.clear();
                         gameState = PAUSE_STATE;
                         menu.setState(PAUSE_STATE);
                         menu.createPauseMenu();
                         break;
                     case SDLK_r:
-                        reset();
+                        // Đấu tay đôi tự sang ván mới, một bên không bắt đầu lại được
+                        if (!duel) {
+                            reset();
+                        }
+                        break;
+                    case SDLK_F3:
+                        showStats = !showStats;
+                        hudDirty = true;
+                        break;
+                    case SDLK_a:
+                        // Đấu trường và đấu tay đôi không có lái tự động
+                        if (!arena && !duel) {
+                            autopilotOn = !autopilotOn;
+                            autopilot.resetStats();
+                            hudDirty = true;
+                        }
                         break;
                 }
             }
@@ -206,154 +415,940 @@ void Game::handleEvents() {
 }
 
 void Game::update() {
-    // Only update the game if in GAME_STATE
-    if (gameState != GAME_STATE) {
+    PROFILE_SCOPE("update");
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 elapsed = now - lastCounter;
+    lastCounter = now;
+
+    // Đấu tay đôi vẫn nhận và gửi gói khi ở menu (đối thủ sẽ đứng chờ)
+    if (duel) {
+        duel->poll();
+    }
+
+    // Only update the game if in GAME_STATE (and the replay is not paused)
+    if (gameState != GAME_STATE || playbackPaused) {
+        accumulator = 0;
+        renderAlpha = 0;
         return;
     }
 
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - lastUpdateTime < gameSpeed) {
-        return; // Chưa đến thời gian cập nhật
+    // Chạy đủ số bước cho thời gian đã trôi qua, mỗi bước dài đúng gameSpeed ms
+    // (chia cho tốc độ phát khi xem replay)
+    int speed = duel ? DuelSim::TICK_MS : sim.getSpeed();
+    Uint64 tickLength = SDL_GetPerformanceFrequency() * speed / 1000 / playbackSpeed;
+    accumulator += elapsed;
+
+    // Sau khi bị treo lâu (kéo cửa sổ...) chỉ đuổi theo tối đa vài bước
+    if (accumulator > tickLength * 5) {
+        accumulator = tickLength * 5;
     }
-    lastUpdateTime = currentTime;
 
-    // Di chuyển rắn
-    snake.move();
+    while (gameState == GAME_STATE && !playbackPaused && accumulator >= tickLength) {
+        accumulator -= tickLength;
+        tick();
+        speed = duel ? DuelSim::TICK_MS : sim.getSpeed();
+        tickLength = SDL_GetPerformanceFrequency() * speed / 1000 / playbackSpeed;
+    }
 
-    // Kiểm tra va chạm
-    checkCollision();
+    renderAlpha = (gameState == GAME_STATE) ? static_cast<double>(accumulator) / tickLength : 0;
 }
 
-void Game::checkCollision() {
-    const SnakeSegment& head = snake.getHead();
+void Game::tick() {
+    PROFILE_SCOPE("tick");
+    if (playback && player.atEnd(sim)) {
+        playbackPaused = true;
+        return;
+    }
+#ifdef SNAKE_PROFILE
+    Profiler::countTick();
+#endif
 
-    // Kiểm tra va chạm với tường
-    if (head.x < 0 || head.x >= SCREEN_WIDTH ||
-        head.y < 0 || head.y >= SCREEN_HEIGHT) {
-        // Game over - va chạm với tường
-        Mix_PlayChannel(-1, crashSound, 0);
-        if (score > highScore) {
-            highScore = score;
+    // Mỗi bước chỉ một lần rẽ từ hàng đợi, các phím bấm nhanh hơn nhịp chờ tới bước sau.
+    // Đấu tay đôi mà bước này phải chờ đối thủ thì lần rẽ cũng chờ, không bị ghi đè.
+    QueuedTurn turn;
+    bool advances = !duel || duel->canAdvance();
+    if (!playback && advances &&
+        inputQueue.pop(turn, SDL_GetPerformanceCounter(), SDL_GetPerformanceFrequency())) {
+        steer(turn.direction);
+        if (showStats) {
+            hudDirty = true;
         }
+    }
 
-        // Show game over menu
-        gameState = GAME_OVER_STATE;
-        menu.setState(GAME_OVER_STATE);
-        menu.createGameOverMenu(score, highScore);
+    if (arena) {
+        tickArena();
+        return;
+    }
+    if (duel) {
+        tickDuel();
         return;
     }
 
-    // Kiểm tra va chạm với thân rắn
-    if (snake.checkSelfCollision()) {
-        // Game over - rắn cắn chính nó
-        Mix_PlayChannel(-1, crashSound, 0);
-        if (score > highScore) {
-            highScore = score;
+    Point oldFood = sim.getFood().getPosition();
+
+    if (autopilotOn && !playback) {
+        steer(autopilot.decide(sim));
+        if (showStats) {
+            hudDirty = true;
         }
+    }
 
-        // Show game over menu
-        gameState = GAME_OVER_STATE;
-        menu.setState(GAME_OVER_STATE);
-        menu.createGameOverMenu(score, highScore);
-        return;
+    // Di chuyển rắn và áp dụng luật chơi
+    StepResult result = playback ? player.step(sim) : sim.step(sim.getDirection());
+    hasPreviousTick = true;
+
+    if (incremental) {
+        // Chỉ đầu mới, đầu cũ (nay là thân), đuôi vừa bỏ và mồi thay đổi
+        const Snake& snake = sim.getSnake();
+        const SnakeBody& segments = snake.getSegments();
+        markDirty(segments[0].x, segments[0].y);
+        markDirty(segments[1].x, segments[1].y);
+        markDirty(snake.getLastTail().x, snake.getLastTail().y);
+
+        Point food = sim.getFood().getPosition();
+        if (food.x != oldFood.x || food.y != oldFood.y) {
+            markDirty(oldFood.x, oldFood.y);
+            markDirty(food.x, food.y);
+            hudDirty = true;
+        }
     }
 
-    // Kiểm tra xem rắn có ăn được mồi không
-    const SDL_Point& foodPos = food.getPosition();
-    if (head.x == foodPos.x && head.y == foodPos.y) {
-        // Rắn ăn mồi
+    if (playback) {
+        // Hết replay thì dừng ở khung hình cuối, không hiện menu game over
+        if (player.atEnd(sim)) {
+            playbackPaused = true;
+        }
+        updateScore();
+    }
+
+    switch (result) {
+        case STEP_ATE:
+            Mix_PlayChannel(-1, eatSound, 0);
+            updateScore();
+            break;
+        case STEP_WON:
+            // Rắn đã phủ kín bàn chơi - thắng
+            Mix_PlayChannel(-1, eatSound, 0);
+            if (!playback) {
+                gameOver(true);
+            }
+            break;
+        case STEP_DIED:
+            // Game over - va chạm với tường hoặc thân rắn
+            Mix_PlayChannel(-1, crashSound, 0);
+            if (!playback) {
+                gameOver(false);
+            }
+            break;
+        case STEP_NONE:
+            break;
+    }
+}
+
+void Game::tickArena() {
+    int oldScore = arena->getSnake(0).score;
+
+    arenaActions[0] = playerDirection;
+    for (int i = 1; i < arena->getSnakeCount(); i++) {
+        arenaActions[i] = arena->decideBot(i);
+    }
+    arena->step(arenaActions.data());
+    hasPreviousTick = true;
+
+    const ArenaSnake& player = arena->getSnake(0);
+    if (!player.alive) {
+        Mix_PlayChannel(-1, crashSound, 0);
+        gameOver(false);
+    } else if (player.score != oldScore) {
         Mix_PlayChannel(-1, eatSound, 0);
-        snake.grow();
-        food.generate(snake.getSegments());
-        score += 10;
         updateScore();
+    } else if (arena->getTick() % 10 == 0) {
+        updateScore(); // Số rắn còn sống
+    }
+}
+
+void Game::tickDuel() {
+    const DuelSim& duelSim = duel->getSim();
+    int self = duel->getPlayerIndex();
+    int oldScore = duelSim.getState().snakes[self].score;
+    bool wasOver = duelSim.isRoundOver();
+
+    // Đang chờ đối thủ: giữ nguyên hình, không nội suy tới một bước chưa có
+    if (!duel->advance(playerDirection)) {
+        hasPreviousTick = false;
+        updateScore();
+        return;
+    }
+    hasPreviousTick = true;
+    updateDuelGrid();
+
+    // Trạng thái hiện tại có thể là dự đoán và bị sửa lại sau rollback;
+    // âm thanh chỉ theo những gì đang hiện trên màn hình
+    const DuelState& state = duelSim.getState();
+    if (state.round != duelRound) {
+        duelRound = state.round;
+        playerDirection = static_cast<Direction>(state.snakes[self].direction);
+    } else if (!wasOver && duelSim.isRoundOver()) {
+        Mix_PlayChannel(-1, crashSound, 0);
+    } else if (state.snakes[self].score > oldScore) {
+        Mix_PlayChannel(-1, eatSound, 0);
+    }
+    updateScore();
+}
+
+void Game::updateDuelGrid() {
+    const DuelSim& duelSim = duel->getSim();
+    duelGrid.clear();
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < duelSim.getState().snakes[i].length; j++) {
+            int cell = duelSim.getSegment(i, j);
+            duelGrid.add(cell % duelSim.getCols(), cell / duelSim.getCols());
+        }
+    }
+}
+
+int Game::getPlayerScore() const {
+    if (duel) {
+        return duel->getSim().getState().snakes[duel->getPlayerIndex()].score;
+    }
+    return arena ? arena->getSnake(0).score : sim.getScore();
+}
+
+void Game::queueTurn(Direction direction) {
+    inputQueue.push(direction, getMovedDirection(), SDL_GetPerformanceCounter());
+}
 
-        // Tăng tốc độ di chuyển (giảm thời gian đợi)
-        if (gameSpeed > 50) {  // Giới hạn tốc độ tối đa
-            gameSpeed -= speedIncrement;
+Direction Game::getMovedDirection() const {
+    if (arena) {
+        return arena->getSnake(0).direction;
+    }
+    if (duel) {
+        return static_cast<Direction>(duel->getSim().getState().snakes[duel->getPlayerIndex()].direction);
+    }
+    // Hướng chỉ đổi ở đầu mỗi bước (hàng đợi, lái tự động) nên đây cũng là hướng vừa đi
+    return sim.getDirection();
+}
+
+void Game::steer(Direction direction) {
+    if (arena) {
+        // Như Snake::setDirection(): không quay đầu ngược lại (hướng ngược là d ^ 1)
+        if (direction != static_cast<Direction>(arena->getSnake(0).direction ^ 1)) {
+            playerDirection = direction;
         }
+        return;
+    }
+    if (duel) {
+        const DuelState& state = duel->getSim().getState();
+        if (direction != static_cast<Direction>(state.snakes[duel->getPlayerIndex()].direction ^ 1)) {
+            playerDirection = direction;
+        }
+        return;
+    }
+
+    // Chỉ ghi những lần đổi hướng có hiệu lực
+    Direction before = sim.getDirection();
+    sim.setDirection(direction);
+    if (recording && sim.getDirection() != before) {
+        replay.record(sim, direction);
     }
 }
 
+void Game::saveReplay() {
+    if (!recording || sim.getTick() == 0) {
+        return;
+    }
+    recording = false;
+    replay.finish(sim);
+
+#ifdef _WIN32
+    _mkdir("replays");
+#else
+    mkdir("replays", 0755);
+#endif
+
+    char path[64];
+    snprintf(path, sizeof(path), "replays/%u_%d.snr", replay.getSeed(), sim.getScore());
+    if (!replay.save(path)) {
+        std::cerr << "Không thể lưu replay " << path << std::endl;
+    }
+}
+
+void Game::handlePlaybackKey(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_SPACE:
+            playbackPaused = !playbackPaused;
+            break;
+        case SDLK_RIGHT:
+            // Đang dừng thì tiến từng bước một
+            if (playbackPaused) {
+                seekPlayback(sim.getTick() + 1);
+            }
+            break;
+        case SDLK_LEFT:
+            if (playbackPaused) {
+                seekPlayback(sim.getTick() - 1);
+            }
+            break;
+        case SDLK_PAGEDOWN:
+            seekPlayback(sim.getTick() + 100);
+            break;
+        case SDLK_PAGEUP:
+            seekPlayback(sim.getTick() - 100);
+            break;
+        case SDLK_HOME:
+            seekPlayback(0);
+            break;
+        case SDLK_END:
+            seekPlayback(static_cast<int>(replay.getFinalTick()));
+            break;
+        case SDLK_UP:
+            if (playbackSpeed < 64) {
+                playbackSpeed *= 2;
+            }
+            updateScore();
+            break;
+        case SDLK_DOWN:
+            if (playbackSpeed > 1) {
+                playbackSpeed /= 2;
+            }
+            updateScore();
+            break;
+        case SDLK_F3:
+            showStats = !showStats;
+            hudDirty = true;
+            break;
+        case SDLK_ESCAPE:
+            running = false;
+            break;
+    }
+}
+
+void Game::seekPlayback(int tick) {
+    // Tua lùi thì mô phỏng lại từ đầu, không cần cửa sổ nên chỉ mất vài ms
+    player.seek(sim, static_cast<Uint32>(tick < 0 ? 0 : tick));
+    hasPreviousTick = false;
+    canvasValid = false;
+    dirtyCells.clear();
+    accumulator = 0;
+    updateScore();
+}
+
+void Game::gameOver(bool won) {
+    saveReplay();
+    inputQueue.clear();
+
+    int score = getPlayerScore();
+    if (score > highScore) {
+        highScore = score;
+    }
+
+    // Show game over menu
+    screenDirty = true;
+    gameState = GAME_OVER_STATE;
+    menu.setState(GAME_OVER_STATE);
+    menu.createGameOverMenu(score, highScore, won);
+}
+
 void Game::run() {
-    // Main game loop
+    // Main game loop: simulation advances in fixed steps inside update(),
+    // rendering runs as often as the frame cap allows
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 frameLength = frequency / 60;
+    lastCounter = SDL_GetPerformanceCounter();
+
     while (running) {
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+
         handleEvents();
+        pollMedia();
         update();
         render();
-        SDL_Delay(16); // Cap frame rate at approximately 60 FPS
+
+        if (!firstFrameTraced) {
+            traceStartup("khung hình đầu tiên");
+            firstFrameTraced = true;
+        }
+
+        if (frameCap == FRAME_CAP_60) {
+            // Sleep most of the remaining frame, then spin for the last millisecond
+            PROFILE_SCOPE("sleep");
+            Uint64 deadline = frameStart + frameLength;
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (now < deadline) {
+                Uint32 remainingMs = static_cast<Uint32>((deadline - now) * 1000 / frequency);
+                if (remainingMs > 1) {
+                    SDL_Delay(remainingMs - 1);
+                }
+                while (SDL_GetPerformanceCounter() < deadline) {
+                }
+            }
+        }
+
+#ifdef SNAKE_PROFILE
+        Profiler::endFrame(SDL_GetPerformanceCounter() - frameStart);
+#endif
     }
 }
 
 void Game::render() {
+    PROFILE_SCOPE("render");
+    if (incremental) {
+        renderIncremental();
+        return;
+    }
+
+    sprites.resetDrawCalls();
+    text.resetDrawCalls();
+    menu.resetDrawCalls();
+
     // Clear the screen
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    // Render background
-    if (backgroundTexture) {
-        SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);
+    // Render background (menu đầu tiên có thể hiện trước khi atlas sẵn sàng)
+    updateCamera();
+    if (mediaReady) {
+        renderBackground();
     }
 
     // Render game objects based on game state
     if (gameState == GAME_STATE) {
-        // Render game elements
-        snake.render();
-        food.render();
+        // Render game elements: background, snake and food go out as one batch
+        renderSnake();
+        renderFood();
+        sprites.flush();
         renderScore();
+        if (showStats) {
+            renderStats();
+        }
     } else {
         // Render menu
+        sprites.flush();
         menu.render();
     }
 
+    drawCalls = sprites.getDrawCalls() + text.getDrawCalls() + menu.getDrawCalls();
+
     // Update the screen
+    present();
+}
+
+void Game::present() {
+    renderProfile();
+
+    PROFILE_SCOPE("present");
     SDL_RenderPresent(renderer);
 }
 
-void Game::updateScore() {
-    // Update score texture
-    if (scoreTexture) {
-        SDL_DestroyTexture(scoreTexture);
-        scoreTexture = nullptr;
+void Game::renderProfile() {
+#ifdef SNAKE_PROFILE
+    if (!showProfile) {
+        return;
     }
 
-    TTF_Font* scoreFont = TTF_OpenFont("assets/font.ttf", 20);
-    if (!scoreFont) {
-        std::cerr << "Không thể tải font điểm số! SDL_ttf Error: " << TTF_GetError() << std::endl;
-        return;
+    // Nền mờ bên phải màn hình
+    const int left = 380;
+    const int lineHeight = text.getHeight(scoreFont);
+    int lines = 3 + Profiler::getPhaseCount();
+    SDL_Rect panel = {left - 10, 5, SCREEN_WIDTH - left + 5, lines * lineHeight + 80};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &panel);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    SDL_Color white = {255, 255, 255, 255};
+    char line[96];
+    int y = 10;
+    snprintf(line, sizeof(line), "Frame %.2f ms  p50 %.2f  p99 %.2f", Profiler::getLastFrameMs(),
+             Profiler::getPercentileMs(0.5), Profiler::getPercentileMs(0.99));
+    text.draw(scoreFont, line, left, y, white);
+    y += lineHeight;
+    snprintf(line, sizeof(line), "Draw calls %d  Ticks/s %.1f", drawCalls, Profiler::getTicksPerSecond());
+    text.draw(scoreFont, line, left, y, white);
+    y += lineHeight;
+    for (int i = 0; i < Profiler::getPhaseCount(); i++) {
+        const Profiler::PhaseStat& phase = Profiler::getPhase(i);
+        snprintf(line, sizeof(line), "  %s %.3f ms", phase.name, phase.lastMs);
+        text.draw(scoreFont, line, left, y, SDL_Color{180, 180, 180, 255});
+        y += lineHeight;
+    }
+    text.flush();
+
+    // Phân bố thời gian khung hình của 240 khung gần nhất, mỗi cột 1 ms (cột cuối: >= 32 ms).
+    // Vạch xanh là p50, vạch đỏ là p99.
+    const int buckets = 33;
+    const int barWidth = 7;
+    const int baseY = y + 70;
+    int counts[buckets] = {};
+    int frames = Profiler::getFrameCount();
+    for (int i = 0; i < frames; i++) {
+        int bucket = static_cast<int>(Profiler::getFrameMs(i));
+        counts[bucket < buckets ? bucket : buckets - 1]++;
+    }
+
+    SDL_Rect bars[buckets];
+    for (int i = 0; i < buckets; i++) {
+        int height = frames > 0 ? counts[i] * 60 / frames : 0;
+        bars[i] = SDL_Rect{left + i * barWidth, baseY - height, barWidth - 1, height};
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    SDL_RenderFillRects(renderer, bars, buckets);
+
+    int p50 = left + static_cast<int>(Profiler::getPercentileMs(0.5) * barWidth);
+    int p99 = left + static_cast<int>(Profiler::getPercentileMs(0.99) * barWidth);
+    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+    SDL_RenderDrawLine(renderer, p50, baseY - 64, p50, baseY);
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+    SDL_RenderDrawLine(renderer, p99, baseY - 64, p99, baseY);
+#endif
+}
+
+void Game::markDirty(int x, int y) {
+    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+        dirtyCells.push_back(Point{x, y});
+    }
+}
+
+void Game::renderCell(int x, int y) {
+    // Phục hồi nền của ô rồi vẽ lại thứ đang nằm trên ô đó (không nội suy).
+    // Ảnh nền được kéo giãn ra cả màn hình nên phải đổi tọa độ ô sang tọa độ ảnh.
+    int backgroundW = sprites.getWidth(backgroundSprite);
+    int backgroundH = sprites.getHeight(backgroundSprite);
+    SDL_Rect part;
+    part.x = x * backgroundW / SCREEN_WIDTH;
+    part.y = y * backgroundH / SCREEN_HEIGHT;
+    part.w = (x + GRID_SIZE) * backgroundW / SCREEN_WIDTH - part.x;
+    part.h = (y + GRID_SIZE) * backgroundH / SCREEN_HEIGHT - part.y;
+    sprites.drawPart(backgroundSprite, part, static_cast<float>(x), static_cast<float>(y), GRID_SIZE, GRID_SIZE);
+
+    const Snake& snake = sim.getSnake();
+    SnakeSegment head = snake.getHead();
+    Point food = sim.getFood().getPosition();
+
+    if (head.x == x && head.y == y) {
+        sprites.draw(headSprites[sim.getDirection()], static_cast<float>(x), static_cast<float>(y), GRID_SIZE, GRID_SIZE);
+    } else if (snake.isOccupied(x, y)) {
+        sprites.draw(bodySprite, static_cast<float>(x), static_cast<float>(y), GRID_SIZE, GRID_SIZE);
+    } else if (food.x == x && food.y == y) {
+        sprites.draw(foodSprite, static_cast<float>(x), static_cast<float>(y), GRID_SIZE, GRID_SIZE);
     }
+}
+
+void Game::renderIncremental() {
+    // Menu đổi rất ít: vẽ lại toàn bộ khi có sự kiện, còn lại không làm gì
+    if (gameState != GAME_STATE) {
+        canvasValid = false;
+        if (!screenDirty && !showProfile) {
+            return;
+        }
+        screenDirty = false;
 
-    std::stringstream scoreText;
-    scoreText << "Score: " << score << "  High Score: " << highScore;
+        sprites.resetDrawCalls();
+        text.resetDrawCalls();
+        menu.resetDrawCalls();
 
-    SDL_Color textColor = {255, 255, 255, 255}; // White
-    SDL_Surface* scoreSurface = TTF_RenderText_Blended(scoreFont, scoreText.str().c_str(), textColor);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        if (mediaReady) {
+            sprites.draw(backgroundSprite, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+            sprites.flush();
+        }
+        menu.render();
 
-    if (!scoreSurface) {
-        std::cerr << "Không thể tạo surface điểm số! SDL_ttf Error: " << TTF_GetError() << std::endl;
-        TTF_CloseFont(scoreFont);
+        drawCalls = sprites.getDrawCalls() + text.getDrawCalls() + menu.getDrawCalls();
+        screenValid = false;
+        present();
         return;
     }
 
-    scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-    scoreRect = {10, 10, scoreSurface->w, scoreSurface->h};
+    if (canvasValid && screenValid && dirtyCells.empty() && !hudDirty && !showProfile) {
+        return; // Không có gì thay đổi, không present
+    }
 
-    SDL_FreeSurface(scoreSurface);
-    TTF_CloseFont(scoreFont);
+    sprites.resetDrawCalls();
+    text.resetDrawCalls();
+    menu.resetDrawCalls();
+    SDL_SetRenderTarget(renderer, canvas);
+
+    // Vùng chữ ở trên cùng: điểm số và tối đa ba dòng thống kê (F3), làm tròn theo ô
+    int hudBottom = 10 + text.getHeight(scoreFont) * 4;
+    int hudRows = std::min(SCREEN_HEIGHT, (hudBottom + GRID_SIZE - 1) / GRID_SIZE * GRID_SIZE);
+    bool fullCopy = !keepsFrame || !screenValid;
+
+    if (!canvasValid) {
+        // Vẽ đầy đủ một lần khi vào màn chơi
+        sprites.draw(backgroundSprite, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+        renderFood();
+        const SnakeBody& segments = sim.getSnake().getSegments();
+        for (size_t i = segments.size(); i-- > 0;) {
+            int sprite = (i == 0) ? headSprites[sim.getDirection()] : bodySprite;
+            sprites.draw(sprite, static_cast<float>(segments[i].x), static_cast<float>(segments[i].y), GRID_SIZE, GRID_SIZE);
+        }
+        canvasValid = true;
+        hudDirty = true;
+        fullCopy = true;
+    } else {
+        // Ô thay đổi nằm dưới dòng điểm số thì phải vẽ lại cả chữ
+        for (const Point& cell : dirtyCells) {
+            if (cell.y < hudBottom) {
+                hudDirty = true;
+            }
+        }
+    }
+
+    bool hudRedrawn = hudDirty;
+    if (hudDirty) {
+        // Vẽ lại các ô dưới vùng chữ trước khi vẽ chữ
+        for (int y = 0; y < hudRows; y += GRID_SIZE) {
+            for (int x = 0; x < SCREEN_WIDTH; x += GRID_SIZE) {
+                renderCell(x, y);
+            }
+        }
+    }
+
+    for (const Point& cell : dirtyCells) {
+        renderCell(cell.x, cell.y);
+    }
+    sprites.flush();
+
+    if (hudDirty) {
+        renderScore();
+        if (showStats) {
+            renderStats();
+        }
+        hudDirty = false;
+    }
+
+    // Chỉ present khi có thay đổi, và chỉ chép ra màn hình phần canvas đã vẽ lại.
+    // Renderer GPU không giữ khung hình cũ sau present, lớp phủ của Profiler thì vẽ
+    // thẳng lên màn hình: hai trường hợp đó phải chép cả canvas.
+    SDL_SetRenderTarget(renderer, nullptr);
+    int copies = 0;
+    if (fullCopy) {
+        SDL_RenderCopy(renderer, canvas, nullptr, nullptr);
+        copies = 1;
+    } else {
+        if (hudRedrawn) {
+            SDL_Rect band = {0, 0, SCREEN_WIDTH, hudRows};
+            SDL_RenderCopy(renderer, canvas, &band, &band);
+            copies++;
+        }
+        for (const Point& cell : dirtyCells) {
+            SDL_Rect rect = {cell.x, cell.y, GRID_SIZE, GRID_SIZE};
+            SDL_RenderCopy(renderer, canvas, &rect, &rect);
+            copies++;
+        }
+    }
+    dirtyCells.clear();
+    drawCalls = sprites.getDrawCalls() + text.getDrawCalls() + copies;
+    screenValid = !showProfile;
+    present();
+}
+
+void Game::updateScore() {
+    PROFILE_SCOPE("updateScore");
+    // Chỉ định dạng lại chuỗi; không mở font, không tạo surface hay texture
+    if (playback) {
+        snprintf(scoreText, sizeof(scoreText), "Replay %d/%u  x%d  Score: %d", sim.getTick(),
+                 replay.getFinalTick(), playbackSpeed, sim.getScore());
+        hudDirty = true;
+        return;
+    }
+    if (arena) {
+        snprintf(scoreText, sizeof(scoreText), "Score: %d  High Score: %d  Alive: %d/%d", getPlayerScore(),
+                 highScore, arena->getAliveCount(), arena->getSnakeCount());
+        return;
+    }
+    if (duel) {
+        const DuelState& state = duel->getSim().getState();
+        int self = duel->getPlayerIndex();
+        if (!duel->isStarted()) {
+            snprintf(scoreText, sizeof(scoreText), "Waiting for opponent...");
+        } else if (duel->isDesynced()) {
+            snprintf(scoreText, sizeof(scoreText), "Desync at tick %d", duel->getDesyncTick());
+        } else {
+            snprintf(scoreText, sizeof(scoreText), "Round %d  You %d - %d Opponent  Score: %d  RTT %d ms",
+                     state.round, state.wins[self], state.wins[1 - self], getPlayerScore(),
+                     static_cast<int>(duel->getStats().rttMs));
+        }
+        return;
+    }
+    snprintf(scoreText, sizeof(scoreText), "Score: %d  High Score: %d", sim.getScore(), highScore);
 }
 
 void Game::renderScore() {
-    if (scoreTexture) {
-        SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
+    text.draw(scoreFont, scoreText, 10, 10, SDL_Color{255, 255, 255, 255}); // White
+    text.flush();
+}
+
+void Game::renderStats() {
+    char stats[96];
+    snprintf(stats, sizeof(stats), "Draw calls: %d", drawCalls);
+    text.draw(scoreFont, stats, 10, 10 + text.getHeight(scoreFont), SDL_Color{255, 255, 0, 255}); // Yellow
+    if (autopilotOn) {
+        snprintf(stats, sizeof(stats), "Autopilot: %.1f us avg, p99 %.1f us, max %.1f us",
+                 autopilot.getMeanMicros(), autopilot.getPercentileMicros(0.99), autopilot.getMaxMicros());
+        text.draw(scoreFont, stats, 10, 10 + text.getHeight(scoreFont) * 2, SDL_Color{255, 255, 0, 255});
+    }
+    if (inputQueue.getAppliedCount() > 0) {
+        snprintf(stats, sizeof(stats), "Input latency: %.1f ms avg, p99 %.1f ms, max %.1f ms, %lld dropped",
+                 inputQueue.getMeanMs(), inputQueue.getPercentileMs(0.99), inputQueue.getMaxMs(),
+                 inputQueue.getDroppedCount());
+        text.draw(scoreFont, stats, 10, 10 + text.getHeight(scoreFont) * 3, SDL_Color{255, 255, 0, 255});
+    }
+    if (duel) {
+        const DuelStats& duelStats = duel->getStats();
+        snprintf(stats, sizeof(stats), "Rollbacks: %lld (max %d ticks, %.0f us)  Stalls: %lld",
+                 duelStats.rollbacks, duelStats.maxRollback, duelStats.maxResimMicros, duelStats.stalls);
+        text.draw(scoreFont, stats, 10, 10 + text.getHeight(scoreFont) * 2, SDL_Color{255, 255, 0, 255});
+    }
+    text.flush();
+}
+
+void Game::updateCamera() {
+    // Tâm camera theo đầu rắn đã nội suy để màn hình trôi đều giữa hai bước
+    SnakeSegment head;
+    SnakeSegment neck;
+    if (arena) {
+        // Rắn của người chơi đang chờ hồi sinh: camera đứng yên
+        const SnakeBody& body = arena->getSnake(0).body;
+        if (body.size() < 2) {
+            return;
+        }
+        head = SnakeSegment{body[0].x * GRID_SIZE, body[0].y * GRID_SIZE};
+        neck = SnakeSegment{body[1].x * GRID_SIZE, body[1].y * GRID_SIZE};
+    } else {
+        head = sim.getSnake().getSegments()[0];
+        neck = sim.getSnake().getSegments()[1];
+    }
+    float alpha = hasPreviousTick ? static_cast<float>(renderAlpha) : 1.0f;
+    float headX = neck.x + (head.x - neck.x) * alpha;
+    float headY = neck.y + (head.y - neck.y) * alpha;
+
+    int worldWidth = sim.getWorldWidth();
+    int worldHeight = sim.getWorldHeight();
+    if (worldWidth <= SCREEN_WIDTH) {
+        cameraX = (worldWidth - SCREEN_WIDTH) / 2;
+    } else {
+        cameraX = static_cast<int>(headX) + GRID_SIZE / 2 - SCREEN_WIDTH / 2;
+        cameraX = std::max(0, std::min(cameraX, worldWidth - SCREEN_WIDTH));
+    }
+    if (worldHeight <= SCREEN_HEIGHT) {
+        cameraY = (worldHeight - SCREEN_HEIGHT) / 2;
+    } else {
+        cameraY = static_cast<int>(headY) + GRID_SIZE / 2 - SCREEN_HEIGHT / 2;
+        cameraY = std::max(0, std::min(cameraY, worldHeight - SCREEN_HEIGHT));
+    }
+}
+
+bool Game::isVisible(float x, float y) const {
+    // Ô bắt đầu tại (x, y) trong tọa độ thế giới có phần nào nằm trên màn hình không
+    return x > cameraX - GRID_SIZE && x < cameraX + SCREEN_WIDTH &&
+           y > cameraY - GRID_SIZE && y < cameraY + SCREEN_HEIGHT;
+}
+
+void Game::renderBackground() {
+    // Thế giới được lát bằng ảnh nền cỡ màn hình nên nền trôi theo camera;
+    // ngoài thế giới (sau tường) để đen. Nhiều nhất 4 mảnh trên màn hình.
+    int worldWidth = sim.getWorldWidth();
+    int worldHeight = sim.getWorldHeight();
+    int backgroundW = sprites.getWidth(backgroundSprite);
+    int backgroundH = sprites.getHeight(backgroundSprite);
+
+    int firstX = std::max(0, cameraX) / SCREEN_WIDTH * SCREEN_WIDTH;
+    int firstY = std::max(0, cameraY) / SCREEN_HEIGHT * SCREEN_HEIGHT;
+    int endX = std::min(worldWidth, cameraX + SCREEN_WIDTH);
+    int endY = std::min(worldHeight, cameraY + SCREEN_HEIGHT);
+
+    for (int tileY = firstY; tileY < endY; tileY += SCREEN_HEIGHT) {
+        for (int tileX = firstX; tileX < endX; tileX += SCREEN_WIDTH) {
+            // Mảnh sát mép thế giới bị cắt bớt, không kéo giãn
+            int w = std::min(SCREEN_WIDTH, worldWidth - tileX);
+            int h = std::min(SCREEN_HEIGHT, worldHeight - tileY);
+            float x = static_cast<float>(tileX - cameraX);
+            float y = static_cast<float>(tileY - cameraY);
+            if (w == SCREEN_WIDTH && h == SCREEN_HEIGHT) {
+                sprites.draw(backgroundSprite, x, y, SCREEN_WIDTH, SCREEN_HEIGHT);
+            } else {
+                SDL_Rect part = {0, 0, w * backgroundW / SCREEN_WIDTH, h * backgroundH / SCREEN_HEIGHT};
+                sprites.drawPart(backgroundSprite, part, x, y, w, h);
+            }
+        }
+    }
+}
+
+void Game::renderSnake() {
+    // Các rắn có phần nằm trong camera (bản đấu trường duyệt qua đầu và đuôi của mọi rắn)
+    visibleSnakes.clear();
+    const Grid* grid;
+    if (arena) {
+        grid = &arena->getGrid();
+        for (int i = 0; i < arena->getSnakeCount(); i++) {
+            const ArenaSnake& snake = arena->getSnake(i);
+            if (!snake.alive) {
+                continue;
+            }
+            const SnakeBody& body = snake.body;
+            SnakeView view;
+            view.head = SnakeSegment{body[0].x * GRID_SIZE, body[0].y * GRID_SIZE};
+            view.neck = SnakeSegment{body[1].x * GRID_SIZE, body[1].y * GRID_SIZE};
+            view.tail = SnakeSegment{body.back().x * GRID_SIZE, body.back().y * GRID_SIZE};
+            view.lastTail = SnakeSegment{snake.lastTail.x * GRID_SIZE, snake.lastTail.y * GRID_SIZE};
+            view.direction = snake.direction;
+            if (isVisible(static_cast<float>(view.head.x), static_cast<float>(view.head.y)) ||
+                isVisible(static_cast<float>(view.neck.x), static_cast<float>(view.neck.y)) ||
+                isVisible(static_cast<float>(view.tail.x), static_cast<float>(view.tail.y)) ||
+                isVisible(static_cast<float>(view.lastTail.x), static_cast<float>(view.lastTail.y))) {
+                visibleSnakes.push_back(view);
+            }
+        }
+    } else if (duel) {
+        const DuelSim& duelSim = duel->getSim();
+        int cols = duelSim.getCols();
+        grid = &duelGrid;
+        for (int i = 0; i < 2; i++) {
+            const DuelSnakeState& snake = duelSim.getState().snakes[i];
+            int tail = duelSim.getSegment(i, snake.length - 1);
+            SnakeView view;
+            view.head = SnakeSegment{duelSim.getSegment(i, 0) % cols * GRID_SIZE, duelSim.getSegment(i, 0) / cols * GRID_SIZE};
+            view.neck = SnakeSegment{duelSim.getSegment(i, 1) % cols * GRID_SIZE, duelSim.getSegment(i, 1) / cols * GRID_SIZE};
+            view.tail = SnakeSegment{tail % cols * GRID_SIZE, tail / cols * GRID_SIZE};
+            view.lastTail = SnakeSegment{snake.lastTail % cols * GRID_SIZE, snake.lastTail / cols * GRID_SIZE};
+            view.direction = static_cast<Direction>(snake.direction);
+            visibleSnakes.push_back(view);
+        }
+    } else {
+        const Snake& snake = sim.getSnake();
+        const SnakeBody& segments = snake.getSegments();
+        grid = &snake.getGrid();
+        SnakeView view = {segments[0], segments[1], segments[segments.size() - 1],
+                          snake.getLastTail(), sim.getDirection()};
+        visibleSnakes.push_back(view);
+    }
+
+    // Nội suy: sau move(), đoạn i đi từ vị trí cũ (nay là đoạn i + 1, hoặc đuôi đã bỏ)
+    // đến vị trí hiện tại
+    float alpha = hasPreviousTick ? static_cast<float>(renderAlpha) : 1.0f;
+
+    // Các đoạn thân nối đuôi nhau nên khi trượt vẫn phủ đúng các ô đang chiếm;
+    // chỉ đầu và đuôi là thật sự di chuyển. Vì vậy thân được vẽ tĩnh theo ô, bằng
+    // cách tra bảng chiếm chỗ cho từng ô trong camera: chi phí tỉ lệ với diện tích
+    // màn hình, không phụ thuộc độ dài rắn hay kích thước thế giới.
+    int firstCol = std::max(0, cameraX / GRID_SIZE);
+    int firstRow = std::max(0, cameraY / GRID_SIZE);
+    int lastCol = std::min(grid->getCols() - 1, (cameraX + SCREEN_WIDTH - 1) / GRID_SIZE);
+    int lastRow = std::min(grid->getRows() - 1, (cameraY + SCREEN_HEIGHT - 1) / GRID_SIZE);
+    int width = lastCol - firstCol + 1;
+    int height = lastRow - firstRow + 1;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Ô có đầu rắn thì đoạn ở đó do đầu nội suy vẽ, không vẽ tĩnh
+    headMarks.assign(width * height, 0);
+    for (const SnakeView& view : visibleSnakes) {
+        int col = view.head.x / GRID_SIZE - firstCol;
+        int row = view.head.y / GRID_SIZE - firstRow;
+        if (view.head.x >= 0 && view.head.y >= 0 && col >= 0 && col < width && row >= 0 && row < height) {
+            headMarks[row * width + col]++;
+        }
+    }
+
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            if (grid->count(firstCol + col, firstRow + row) > headMarks[row * width + col]) {
+                sprites.draw(bodySprite, static_cast<float>((firstCol + col) * GRID_SIZE - cameraX),
+                             static_cast<float>((firstRow + row) * GRID_SIZE - cameraY), GRID_SIZE, GRID_SIZE);
+            }
+        }
+    }
+
+    for (const SnakeView& view : visibleSnakes) {
+        // Đuôi trượt từ ô vừa bỏ vào ô đuôi hiện tại
+        float tailX = view.lastTail.x + (view.tail.x - view.lastTail.x) * alpha;
+        float tailY = view.lastTail.y + (view.tail.y - view.lastTail.y) * alpha;
+        if (isVisible(tailX, tailY)) {
+            sprites.draw(bodySprite, tailX - cameraX, tailY - cameraY, GRID_SIZE, GRID_SIZE);
+        }
+    }
+
+    // Đầu rắn dùng hình đã xoay sẵn theo hướng đi, vẽ sau cùng để nằm trên thân
+    for (const SnakeView& view : visibleSnakes) {
+        float headX = view.neck.x + (view.head.x - view.neck.x) * alpha;
+        float headY = view.neck.y + (view.head.y - view.neck.y) * alpha;
+        if (isVisible(headX, headY)) {
+            sprites.draw(headSprites[view.direction], headX - cameraX, headY - cameraY, GRID_SIZE, GRID_SIZE);
+        }
+    }
+}
+
+void Game::renderFood() {
+    if (arena) {
+        // Mồi của đấu trường cũng tra theo ô trong camera
+        int firstCol = std::max(0, cameraX / GRID_SIZE);
+        int firstRow = std::max(0, cameraY / GRID_SIZE);
+        int lastCol = std::min(arena->getCols() - 1, (cameraX + SCREEN_WIDTH - 1) / GRID_SIZE);
+        int lastRow = std::min(arena->getRows() - 1, (cameraY + SCREEN_HEIGHT - 1) / GRID_SIZE);
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int col = firstCol; col <= lastCol; col++) {
+                if (arena->hasFood(col, row)) {
+                    sprites.draw(foodSprite, static_cast<float>(col * GRID_SIZE - cameraX),
+                                 static_cast<float>(row * GRID_SIZE - cameraY), GRID_SIZE, GRID_SIZE);
+                }
+            }
+        }
+        return;
+    }
+
+    if (duel) {
+        int food = duel->getSim().getState().food;
+        if (food >= 0) {
+            int cols = duel->getSim().getCols();
+            sprites.draw(foodSprite, static_cast<float>(food % cols * GRID_SIZE - cameraX),
+                         static_cast<float>(food / cols * GRID_SIZE - cameraY), GRID_SIZE, GRID_SIZE);
+        }
+        return;
+    }
+
+    Point position = sim.getFood().getPosition();
+    if (isVisible(static_cast<float>(position.x), static_cast<float>(position.y))) {
+        sprites.draw(foodSprite, static_cast<float>(position.x - cameraX),
+                     static_cast<float>(position.y - cameraY), GRID_SIZE, GRID_SIZE);
     }
 }
 
 void Game::reset() {
-    // Reset game state
-    snake.init(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
-    food.generate(snake.getSegments());
-    score = 0;
-    gameSpeed = 150; // Reset speed to initial value
+    if (!awaitMedia()) {
+        gameState = MENU_STATE;
+        return;
+    }
+
+    if (playback) {
+        player.start(replay, sim);
+        playbackPaused = false;
+    } else if (arena) {
+        arena->reset(static_cast<unsigned int>(time(nullptr)));
+        playerDirection = arena->getSnake(0).direction;
+    } else if (duel) {
+        // Trận đấu do hai bên cùng chạy; Play chỉ quay lại màn chơi
+        playerDirection = static_cast<Direction>(duel->getSim().getState().snakes[duel->getPlayerIndex()].direction);
+    } else {
+        // Lưu ván trước nếu bị bỏ dở, rồi ghi ván mới (seed mới cho mỗi ván).
+        // Thế giới quá lớn thì không ghi, vì tệp đó sẽ không đọc lại được.
+        saveReplay();
+        unsigned int seed = static_cast<unsigned int>(time(nullptr));
+        sim.reset(seed);
+        replay.begin(sim, seed);
+        recording = static_cast<long long>(sim.getWorldWidth() / sim.getGridSize()) *
+                    (sim.getWorldHeight() / sim.getGridSize()) <= Replay::MAX_CELLS;
+    }
+    // Độ trễ phím trên F3 tính riêng cho từng ván
+    inputQueue.clear();
+    inputQueue.resetStats();
+    hasPreviousTick = false;
+    canvasValid = false;
+    dirtyCells.clear();
+    accumulator = 0;
     updateScore();
     gameState = GAME_STATE;
 }
@@ -361,7 +1356,3 @@ void Game::reset() {
 bool Game::isRunning() const {
     return running;
 }
-
-void Game::generateFood() {
-    food.generate(snake.getSegments());
-}
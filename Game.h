@@ -4,53 +4,211 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
+#include <memory>
 #include <vector>
 #include <string>
 
-#include "Snake.h"
-#include "Food.h"
+#include "GameSim.h"
+#include "ArenaSim.h"
+#include "DuelSession.h"
+#include "Autopilot.h"
+#include "InputQueue.h"
 #include "Menu.h"
+#include "TextRenderer.h"
+#include "SpriteBatch.h"
+#include "AssetPack.h"
+#include "AssetLoader.h"
+#include "Replay.h"
+
+// Giới hạn tốc độ vẽ; mô phỏng luôn chạy đúng nhịp gameSpeed bất kể chế độ nào
+enum FrameCap {
+    FRAME_CAP_60,     // Ngủ đến khung hình kế tiếp (~60 FPS)
+    FRAME_CAP_VSYNC,  // Đồng bộ theo màn hình
+    FRAME_CAP_NONE    // Vẽ nhanh nhất có thể
+};
+
+// Những gì cần để vẽ một con rắn, tọa độ điểm ảnh: thân được vẽ theo ô từ
+// bảng chiếm chỗ, chỉ đầu và đuôi là nội suy
+struct SnakeView {
+    SnakeSegment head;
+    SnakeSegment neck;      // Đoạn thứ hai, ô đầu rắn vừa rời đi
+    SnakeSegment tail;
+    SnakeSegment lastTail;  // Ô đuôi vừa rời đi
+    Direction direction;
+};
 
 class Game {
 private:
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Texture* backgroundTexture;
+
+    // Tài nguyên đọc từ gói assets.pak nếu có, nếu không thì từ các tệp rời.
+    // Khai báo trước menu vì font của menu đọc thẳng từ vùng nhớ của gói.
+    AssetPack assets;
+    bool looseAssets;
+
+    // Ảnh và âm thanh của màn chơi được giải mã trên luồng phụ trong khi menu
+    // đã hiện; chỉ bước tải atlas lên GPU chạy trên luồng vẽ (finishMedia)
+    AssetLoader loader;
+    bool mediaReady;
+    int backgroundJob;
+    int headJob;
+    int bodyJob;
+    int foodJob;
+    int eatJob;
+    int crashJob;
+
+    // Mốc thời gian khởi động, in ra theo từng giai đoạn
+    Uint64 startCounter;
+    bool firstFrameTraced;
+
+    // Mọi hình của màn chơi nằm trong một atlas, đầu rắn xoay sẵn theo 4 hướng
+    SpriteBatch sprites;
+    int backgroundSprite;
+    int bodySprite;
+    int foodSprite;
+    int headSprites[4]; // Theo Direction
+
+    // Số lần gọi vẽ của khung hình trước, hiện bằng F3
+    int drawCalls;
+    bool showStats;
+    bool showProfile;   // Lớp phủ của Profiler (F4), chỉ có trong bản SNAKE_PROFILE
+
+    // Chế độ vẽ tăng dần (cho renderer phần mềm): khung hình giữ trong canvas,
+    // mỗi bước chỉ vẽ lại các ô thay đổi và chỉ present khi có thay đổi
+    bool incremental;
+    bool forceSoftware;
+    SDL_Texture* canvas;
+    bool canvasValid;   // canvas đang khớp với trạng thái màn chơi
+    bool screenDirty;   // Màn hình (menu) cần vẽ lại
+    bool keepsFrame;    // Màn hình giữ nguyên khung hình cũ sau present (renderer phần mềm)
+    bool screenValid;   // Màn hình đang khớp canvas, chỉ cần chép các ô thay đổi
+    bool hudDirty;
+    std::vector<Point> dirtyCells;
 
     // Am thanh
     Mix_Chunk* eatSound;
     Mix_Chunk* crashSound;
 
     // Doi tuong game
-    Snake snake;
-    Food food;
+    GameSim sim;
     Menu menu;
 
+    // Góc trên trái của màn hình trong tọa độ thế giới (điểm ảnh). Camera đi theo
+    // đầu rắn và dừng ở mép thế giới; thế giới nhỏ hơn màn hình thì nằm giữa.
+    int cameraX;
+    int cameraY;
+
+    // Khi vẽ: các rắn có phần nằm trong camera, và số đầu rắn trên từng ô của camera
+    std::vector<SnakeView> visibleSnakes;
+    std::vector<unsigned char> headMarks;
+
+    // Phím mũi tên xếp vào hàng đợi, mỗi bước áp dụng một lần rẽ qua steer()
+    InputQueue inputQueue;
+
+    // Lái tự động (phím A), đi qua steer() nên vẫn được ghi vào replay
+    Autopilot autopilot;
+    bool autopilotOn;
+
+    // Đấu trường nhiều rắn (--arena): người chơi là rắn 0, còn lại là bot.
+    // Khi đó sim chỉ còn cho kích thước thế giới và tốc độ; không ghi replay.
+    std::unique_ptr<ArenaSim> arena;
+    int arenaBots;
+    std::vector<Direction> arenaActions;
+    Direction playerDirection;
+
+    // Đấu tay đôi qua mạng (--duel-host / --duel-join): bàn cỡ màn hình, nhịp cố định
+    // DuelSim::TICK_MS. Người chơi là rắn getPlayerIndex(); không ghi replay.
+    std::unique_ptr<DuelSession> duel;
+    bool duelHost;
+    std::string duelAddress;
+    int duelPort;
+    int netLatency;         // Giả lập đường truyền xấu, xem DuelSession::setLinkConditions()
+    int netJitter;
+    double netLoss;
+    int duelRound;
+    Grid duelGrid;          // Bảng chiếm chỗ dựng lại từ DuelState sau mỗi bước, để vẽ thân rắn
+
     // Trang thai game
     GameState gameState;
     bool running;
-    int score;
     int highScore;
 
-    Uint32 lastUpdateTime;
-    int gameSpeed;
-    int speedIncrement; // Tăng tốc sau mỗi lần ăn mồi
+    // Vòng lặp bước cố định: thời gian tích lũy tính theo SDL_GetPerformanceCounter
+    FrameCap frameCap;
+    Uint64 lastCounter;
+    Uint64 accumulator;
+    double renderAlpha;     // Tỉ lệ đã trôi qua của bước hiện tại, dùng để nội suy khi vẽ
+    bool hasPreviousTick;   // Đã có bước nào kể từ reset() (mới có vị trí cũ để nội suy)
+
+    // Mỗi ván được ghi lại (replays/<seed>_<điểm>.snr) để có thể chơi lại y hệt.
+    // Với --replay, game chỉ phát lại tệp đó: dừng, tua và đổi tốc độ bằng phím.
+    Replay replay;
+    bool recording;         // Ván hiện tại đang được ghi và chưa lưu
+    std::string replayFile;
+    bool playback;
+    ReplayPlayer player;
+    bool playbackPaused;
+    int playbackSpeed;      // Số lần tốc độ thật
 
-    // Font hiển thị điểm số
-    SDL_Texture* scoreTexture;
-    SDL_Rect scoreRect;
+    // Chữ vẽ từ atlas glyph, điểm số chỉ định dạng lại khi thay đổi
+    TextRenderer text;
+    int scoreFont;
+    char scoreText[64];
 
     // Hàm hỗ trợ
-    bool loadMedia();
+    void queueMedia();
+    bool finishMedia();
+    void pollMedia();
+    bool awaitMedia();
+    int takeSprite(int job, const char* name);
+    void traceStartup(const char* stage);
     void updateScore();
     void renderScore();
-    void checkCollision();
-    void generateFood();
+    void updateCamera();
+    bool isVisible(float x, float y) const;
+    void renderBackground();
+    void renderSnake();
+    void renderFood();
+    void renderStats();
+    void renderProfile();
+    void present();
+    void renderIncremental();
+    void renderCell(int x, int y);
+    void markDirty(int x, int y);
+    void tick();
+    void tickArena();
+    void tickDuel();
+    void updateDuelGrid();
+    int getPlayerScore() const;
+    void queueTurn(Direction direction);
+    Direction getMovedDirection() const;
+    void steer(Direction direction);
+    void saveReplay();
+    void handlePlaybackKey(SDL_Keycode key);
+    void seekPlayback(int tick);
+    void gameOver(bool won);
 
 public:
     Game();
     ~Game();
 
+    void setFrameCap(FrameCap cap) { frameCap = cap; }
+    // Bật chế độ vẽ tăng dần; tự bật khi renderer là renderer phần mềm
+    void setIncremental(bool enabled) { incremental = enabled; }
+    void setSoftwareRenderer(bool enabled) { forceSoftware = enabled; }
+    // Bỏ qua assets.pak, đọc và giải mã các tệp rời (để so sánh thời gian khởi động)
+    void setLooseAssets(bool enabled) { looseAssets = enabled; }
+    // Kích thước bàn chơi tính theo ô, mặc định vừa khít cửa sổ
+    void setWorldSize(int cols, int rows) { sim = GameSim(GRID_SIZE, cols * GRID_SIZE, rows * GRID_SIZE); }
+    // Chơi cùng bots con rắn máy trên cùng một bàn
+    void setArena(int bots) { arenaBots = bots; }
+    // Đấu tay đôi: chờ đối thủ ở cổng port, hoặc tham gia trận của address:port
+    void setDuelHost(int port) { duelHost = true; duelPort = port; }
+    void setDuelJoin(const std::string& address, int port) { duelHost = false; duelAddress = address; duelPort = port; }
+    void setNetworkConditions(int latency, int jitter, double loss) { netLatency = latency; netJitter = jitter; netLoss = loss; }
+    // Phát lại một tệp replay thay vì chơi
+    void setReplayFile(const char* path) { replayFile = path; playback = true; }
     bool init();
     void handleEvents();
     void update();
@@ -0,0 +1,106 @@
+#include "GameSim.h"
+
+GameSim::GameSim(int gridSize, int worldWidth, int worldHeight)
+    : snake(gridSize, worldWidth, worldHeight),
+      food(gridSize, worldWidth, worldHeight),
+      gridSize(gridSize), worldWidth(worldWidth), worldHeight(worldHeight),
+      over(false), score(0), tick(0), gameSpeed(150), speedIncrement(5) {
+}
+
+void GameSim::reset(unsigned int seed) {
+    // Ô giữa bàn, không phải điểm ảnh giữa: với số ô lẻ, điểm giữa lệch nửa ô
+    // khỏi lưới và rắn không bao giờ trùng ô với mồi
+    snake.init((worldWidth / gridSize / 2) * gridSize, (worldHeight / gridSize / 2) * gridSize);
+    food.seed(seed);
+    food.generate(snake);
+
+    over = false;
+    score = 0;
+    tick = 0;
+    gameSpeed = 150; // Tốc độ ban đầu
+}
+
+StepResult GameSim::step(Direction newDir) {
+    if (over) {
+        return STEP_DIED;
+    }
+
+    snake.setDirection(newDir);
+
+    // Di chuyển rắn
+    snake.move();
+    tick++;
+
+    const SnakeSegment& head = snake.getHead();
+
+    // Kiểm tra va chạm với tường
+    if (head.x < 0 || head.x >= worldWidth ||
+        head.y < 0 || head.y >= worldHeight) {
+        over = true;
+        return STEP_DIED;
+    }
+
+    // Kiểm tra va chạm với thân rắn
+    if (snake.checkSelfCollision()) {
+        over = true;
+        return STEP_DIED;
+    }
+
+    // Kiểm tra xem rắn có ăn được mồi không
+    Point foodPos = food.getPosition();
+    if (head.x == foodPos.x && head.y == foodPos.y) {
+        snake.grow();
+        score += FOOD_SCORE;
+
+        // Tăng tốc độ di chuyển (giảm thời gian đợi)
+        if (gameSpeed > 50) {  // Giới hạn tốc độ tối đa
+            gameSpeed -= speedIncrement;
+        }
+
+        if (!food.generate(snake)) {
+            // Rắn đã phủ kín bàn chơi
+            over = true;
+            return STEP_WON;
+        }
+
+        return STEP_ATE;
+    }
+
+    return STEP_NONE;
+}
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t hashInt(uint64_t hash, int value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++) {
+        hash ^= (bits >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+}
+
+uint64_t GameSim::getStateHash() const {
+    uint64_t hash = FNV_OFFSET;
+    hash = hashInt(hash, tick);
+    hash = hashInt(hash, score);
+    hash = hashInt(hash, over ? 1 : 0);
+    hash = hashInt(hash, snake.getDirection());
+
+    Point foodPos = food.getPosition();
+    hash = hashInt(hash, foodPos.x);
+    hash = hashInt(hash, foodPos.y);
+
+    const SnakeBody& segments = snake.getSegments();
+    hash = hashInt(hash, static_cast<int>(segments.size()));
+    for (const SnakeSegment& segment : segments) {
+        hash = hashInt(hash, segment.x);
+        hash = hashInt(hash, segment.y);
+    }
+    return hash;
+}
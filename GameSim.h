@@ -0,0 +1,65 @@
+#ifndef GAMESIM_H
+#define GAMESIM_H
+
+#include <cstdint>
+
+#include "Snake.h"
+#include "Food.h"
+
+// Kết quả của một bước mô phỏng
+enum StepResult {
+    STEP_NONE,  // Rắn chỉ di chuyển
+    STEP_ATE,   // Rắn ăn mồi
+    STEP_DIED,  // Rắn đâm vào tường hoặc chính nó
+    STEP_WON    // Rắn ăn mồi và phủ kín bàn chơi
+};
+
+// Luật chơi thuần túy, không phụ thuộc SDL: có thể chạy không cần cửa sổ
+// với tốc độ tối đa. Game chỉ là lớp hiển thị bên trên GameSim.
+// Kích thước thế giới (điểm ảnh) không liên quan tới cửa sổ: bàn chơi có thể
+// lớn hơn màn hình nhiều lần, Game chỉ vẽ phần nằm trong camera.
+class GameSim {
+private:
+    Snake snake;
+    Food food;
+
+    int gridSize;
+    int worldWidth;
+    int worldHeight;
+
+    bool over;
+    int score;
+    int tick;
+
+    int gameSpeed;      // Thời gian giữa hai bước (ms)
+    int speedIncrement; // Tăng tốc sau mỗi lần ăn mồi
+
+public:
+    static const int FOOD_SCORE = 10; // Điểm cho mỗi lần ăn mồi
+    static const int MAX_CELLS = 1 << 26; // Bàn chơi lớn nhất (8192x8192 ô)
+
+    GameSim(int gridSize, int worldWidth, int worldHeight);
+
+    void reset(unsigned int seed);
+    void setDirection(Direction newDir) {snake.setDirection(newDir);}
+    StepResult step(Direction newDir);
+
+    const Snake& getSnake() const {return snake;}
+    const Food& getFood() const {return food;}
+    Direction getDirection() const {return snake.getDirection();}
+
+    int getGridSize() const {return gridSize;}
+    int getWorldWidth() const {return worldWidth;}
+    int getWorldHeight() const {return worldHeight;}
+
+    bool isOver() const {return over;}
+    int getScore() const {return score;}
+    int getTick() const {return tick;}
+    int getSpeed() const {return gameSpeed;}
+
+    // Băm FNV-1a của toàn bộ trạng thái (rắn, mồi, hướng, điểm, bước),
+    // dùng để kiểm tra hai lần mô phỏng có cho cùng kết quả không
+    uint64_t getStateHash() const;
+};
+
+#endif // GAMESIM_H
@@ -0,0 +1,22 @@
+#include "Grid.h"
+
+Grid::Grid() : cols(0), rows(0) {
+}
+
+void Grid::resize(int cols, int rows) {
+    this->cols = cols;
+    this->rows = rows;
+    cells.assign(cols * rows, 0);
+    freeCells.reserve(cols * rows);
+    slotOf.resize(cols * rows);
+    clear();
+}
+
+void Grid::clear() {
+    cells.assign(cells.size(), 0);
+    freeCells.clear();
+    for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+        slotOf[i] = i;
+        freeCells.push_back(i);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <vector>
+
+struct Point {
+    int x, y;
+};
+
+// Bảng chiếm chỗ của bàn chơi: mỗi ô giữ số đoạn rắn đang nằm trên nó.
+// Dùng bộ đếm thay vì bit vì grow() tạm thời nhân đôi đoạn đuôi.
+// Song song đó là danh sách các ô trống (mảng đặc + bảng vị trí -> slot)
+// để chọn ngẫu nhiên một ô trống trong O(1).
+class Grid {
+private:
+    int cols;
+    int rows;
+    std::vector<unsigned char> cells;
+    std::vector<int> freeCells; // Chỉ số các ô trống, không theo thứ tự
+    std::vector<int> slotOf;    // Vị trí của mỗi ô trong freeCells, -1 nếu bị chiếm
+
+    void markOccupied(int index) {
+        // Xóa bằng cách đổi chỗ với phần tử cuối
+        int slot = slotOf[index];
+        int last = freeCells.back();
+        freeCells[slot] = last;
+        slotOf[last] = slot;
+        freeCells.pop_back();
+        slotOf[index] = -1;
+    }
+
+    void markFree(int index) {
+        slotOf[index] = static_cast<int>(freeCells.size());
+        freeCells.push_back(index);
+    }
+
+public:
+    Grid();
+
+    void resize(int cols, int rows);
+    void clear();
+
+    bool contains(int col, int row) const {
+        return col >= 0 && col < cols && row >= 0 && row < rows;
+    }
+
+    // Ô nằm ngoài bàn chơi được bỏ qua (đầu rắn vừa đâm vào tường)
+    void add(int col, int row) {
+        if (contains(col, row)) {
+            int index = row * cols + col;
+            if (cells[index]++ == 0) {
+                markOccupied(index);
+            }
+        }
+    }
+
+    void remove(int col, int row) {
+        if (contains(col, row)) {
+            int index = row * cols + col;
+            if (--cells[index] == 0) {
+                markFree(index);
+            }
+        }
+    }
+
+    int count(int col, int row) const {
+        return contains(col, row) ? cells[row * cols + col] : 0;
+    }
+
+    bool isOccupied(int col, int row) const { return count(col, row) > 0; }
+
+    int getFreeCount() const { return static_cast<int>(freeCells.size()); }
+    // Ô trống thứ i (0 <= i < getFreeCount()), trả về chỉ số row * cols + col
+    int getFreeCell(int i) const { return freeCells[i]; }
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+};
+
+#endif // GRID_H
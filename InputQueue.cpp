@@ -0,0 +1,62 @@
+#include "InputQueue.h"
+
+#include <algorithm>
+
+InputQueue::InputQueue()
+    : first(0), count(0), dropped(0),
+      latencies(LATENCY_HISTORY), sorted(LATENCY_HISTORY),
+      applied(0), totalMs(0), maxMs(0) {
+}
+
+bool InputQueue::push(Direction direction, Direction current, uint64_t stamp) {
+    // So với hướng mà rắn sẽ có khi tới lượt lần rẽ này (hướng ngược là d ^ 1)
+    Direction last = count > 0 ? turns[(first + count - 1) % CAPACITY].direction : current;
+    if (direction == last || direction == static_cast<Direction>(last ^ 1)) {
+        return false;
+    }
+    if (count == CAPACITY) {
+        dropped++;
+        return false;
+    }
+
+    turns[(first + count) % CAPACITY] = QueuedTurn{direction, stamp};
+    count++;
+    return true;
+}
+
+bool InputQueue::pop(QueuedTurn& turn, uint64_t now, uint64_t frequency) {
+    if (count == 0) {
+        return false;
+    }
+    turn = turns[first];
+    first = (first + 1) % CAPACITY;
+    count--;
+
+    double ms = static_cast<double>(now - turn.stamp) * 1000.0 / frequency;
+    latencies[applied % LATENCY_HISTORY] = ms;
+    applied++;
+    totalMs += ms;
+    if (ms > maxMs) {
+        maxMs = ms;
+    }
+    return true;
+}
+
+double InputQueue::getPercentileMs(double p) const {
+    int samples = static_cast<int>(std::min<long long>(applied, LATENCY_HISTORY));
+    if (samples == 0) {
+        return 0;
+    }
+
+    std::copy(latencies.begin(), latencies.begin() + samples, sorted.begin());
+    int index = static_cast<int>(p * (samples - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.begin() + samples);
+    return sorted[index];
+}
+
+void InputQueue::resetStats() {
+    applied = 0;
+    dropped = 0;
+    totalMs = 0;
+    maxMs = 0;
+}
@@ -0,0 +1,61 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Snake.h"
+
+// Một lần bấm phím đổi hướng, kèm thời điểm bấm (SDL_GetPerformanceCounter)
+struct QueuedTurn {
+    Direction direction;
+    uint64_t stamp;
+};
+
+// Hàng đợi hướng đi giữa các bước mô phỏng: mỗi bước chỉ lấy ra một lần rẽ, nên hai
+// phím bấm nhanh trong cùng một bước (Lên rồi Trái khi đang sang phải) thành hai lần
+// rẽ ở hai bước liên tiếp thay vì ghi đè nhau.
+//
+// Mỗi lần rẽ được kiểm tra với lần rẽ cuối trong hàng đợi (hoặc hướng rắn đang đi nếu
+// hàng đợi rỗng): trùng hướng hay quay ngược đều bị bỏ, nên rắn không thể quay đầu vào
+// cổ của chính nó. Hàng đợi đầy thì phím mới bị bỏ.
+//
+// Độ trễ từ lúc bấm tới bước áp dụng được đo lại để hiện trong thống kê (F3).
+class InputQueue {
+private:
+    static const int CAPACITY = 3;
+    static const int LATENCY_HISTORY = 1024;
+
+    QueuedTurn turns[CAPACITY];
+    int first;
+    int count;
+    long long dropped;
+
+    // Độ trễ của các lần rẽ gần nhất (mili giây)
+    std::vector<double> latencies;
+    mutable std::vector<double> sorted;
+    long long applied;
+    double totalMs;
+    double maxMs;
+
+public:
+    InputQueue();
+
+    // current: hướng của bước gần nhất. Trả về false nếu lần rẽ bị bỏ.
+    bool push(Direction direction, Direction current, uint64_t stamp);
+    // Lấy lần rẽ cho bước này; now và frequency theo SDL_GetPerformanceCounter để đo độ trễ
+    bool pop(QueuedTurn& turn, uint64_t now, uint64_t frequency);
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+
+    // Thống kê độ trễ từ lúc bấm phím tới bước áp dụng
+    long long getAppliedCount() const { return applied; }
+    long long getDroppedCount() const { return dropped; }
+    double getMeanMs() const { return applied > 0 ? totalMs / applied : 0; }
+    double getMaxMs() const { return maxMs; }
+    double getPercentileMs(double p) const; // Trên LATENCY_HISTORY lần rẽ gần nhất
+    void resetStats();
+};
+
+#endif // INPUTQUEUE_H
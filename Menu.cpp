@@ -1,89 +1,41 @@
 #include "Menu.h"
+#include "Profiler.h"
 #include <iostream>
-#include <sstream>
-#include <SDL_image.h>
+#include <cstdio>
 
-Menu::Menu(SDL_Renderer* renderer)
-    : renderer(renderer), font(nullptr), titleFont(nullptr), selectedIndex(0),
-      backgroundTexture(nullptr), currentState(MENU_STATE),
-      titleTexture(nullptr), gameOverTexture(nullptr), finalScoreTexture(nullptr) {
+Menu::Menu(SDL_Renderer* renderer, TextRenderer* text, AssetPack* assets)
+    : renderer(renderer), text(text), assets(assets), font(nullptr), titleFont(0), textFont(0), selectedIndex(0),
+      currentState(MENU_STATE), won(false), drawCalls(0), loadingDone(0), loadingTotal(0) {
+    finalScoreText[0] = '\0';
 }
 
 Menu::~Menu() {
     clearMenuItems();
 
-    if (backgroundTexture) {
-        SDL_DestroyTexture(backgroundTexture);
-    }
-
-    if (titleTexture) {
-        SDL_DestroyTexture(titleTexture);
-    }
-
-    if (gameOverTexture) {
-        SDL_DestroyTexture(gameOverTexture);
-    }
-
-    if (finalScoreTexture) {
-        SDL_DestroyTexture(finalScoreTexture);
-    }
-
     if (font) {
         TTF_CloseFont(font);
     }
-
-    if (titleFont) {
-        TTF_CloseFont(titleFont);
-    }
 }
 
 bool Menu::init() {
+    PROFILE_SCOPE("menuInit");
     // Load fonts
-    font = TTF_OpenFont("assets/font.ttf", 24);
+    font = TTF_OpenFontRW(assets->openFile("font.ttf"), 1, 24);
     if (!font) {
         std::cerr << "Failed to load menu font! SDL_ttf Error: " << TTF_GetError() << std::endl;
         return false;
     }
 
-    titleFont = TTF_OpenFont("assets/font.ttf", 48);
-    if (!titleFont) {
-        std::cerr << "Failed to load title font! SDL_ttf Error: " << TTF_GetError() << std::endl;
-        return false;
-    }
+    titleFont = text->addFont(48);
+    textFont = text->addFont(24);
 
-    // Load menu background
-    SDL_Surface* menuBgSurface = IMG_Load("assets/menu_background.png");
-    if (!menuBgSurface) {
-        std::cerr << "Failed to load menu background! SDL_image Error: " << IMG_GetError() << std::endl;
-        // Create a fallback texture with plain color if image loading fails
-        backgroundTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
-                                             SDL_TEXTUREACCESS_TARGET, 640, 480);
-        SDL_SetRenderTarget(renderer, backgroundTexture);
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        SDL_SetRenderTarget(renderer, NULL);
-    } else {
-        backgroundTexture = SDL_CreateTextureFromSurface(renderer, menuBgSurface);
-        SDL_FreeSurface(menuBgSurface);
-
-        if (!backgroundTexture) {
-            std::cerr << "Failed to create menu background texture! SDL Error: " << SDL_GetError() << std::endl;
-            return false;
-        }
-    }
-
-    // Create title
-    SDL_Color titleColor = {255, 255, 0, 255}; // Yellow
-    SDL_Surface* titleSurface = TTF_RenderText_Blended(titleFont, "Snake Game", titleColor);
-    if (!titleSurface) {
-        std::cerr << "Failed to render title text! SDL_ttf Error: " << TTF_GetError() << std::endl;
+    // Rasterize every menu label once; state switches reuse these textures
+    if (!buildItems(MENU_STATE, {"Play", "Instructions", "Quit"}, 200, 60) ||
+        !buildItems(PAUSE_STATE, {"Resume", "Restart", "Main Menu", "Quit"}, 180, 50) ||
+        !buildItems(GAME_OVER_STATE, {"Play Again", "Main Menu", "Quit"}, 220, 50)) {
         return false;
     }
 
-    titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-    titleRect = {320 - titleSurface->w / 2, 80, titleSurface->w, titleSurface->h};
-    SDL_FreeSurface(titleSurface);
-
     // Initialize with main menu
     createMainMenu();
 
@@ -91,193 +43,112 @@ bool Menu::init() {
 }
 
 void Menu::clearMenuItems() {
-    for (auto& item : items) {
-        if (item.texture) {
-            SDL_DestroyTexture(item.texture);
-            item.texture = nullptr;
+    for (auto& items : menus) {
+        for (auto& item : items) {
+            if (item.texture) {
+                SDL_DestroyTexture(item.texture);
+                item.texture = nullptr;
+            }
         }
+        items.clear();
     }
-    items.clear();
 }
 
-void Menu::createMainMenu() {
-    clearMenuItems();
-
-    std::vector<std::string> menuTexts = {"Play", "Instructions", "Quit"};
-    SDL_Color normalColor = {255, 255, 255, 255}; // White
-    SDL_Color selectedColor = {255, 255, 0, 255}; // Yellow
-
-    int yPos = 200;
-    const int spacing = 60;
-
-    for (size_t i = 0; i < menuTexts.size(); i++) {
-        MenuItem item;
-        item.text = menuTexts[i];
-        item.selected = (i == selectedIndex);
-
-        SDL_Color textColor = item.selected ? selectedColor : normalColor;
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, item.text.c_str(), textColor);
+bool Menu::buildItems(GameState state, const std::vector<std::string>& labels, int yPos, int spacing) {
+    SDL_Color white = {255, 255, 255, 255};
 
+    for (const std::string& label : labels) {
+        SDL_Surface* textSurface = TTF_RenderText_Blended(font, label.c_str(), white);
         if (!textSurface) {
             std::cerr << "Failed to render menu text! SDL_ttf Error: " << TTF_GetError() << std::endl;
-            continue;
+            return false;
         }
 
+        MenuItem item;
+        item.text = label;
         item.texture = SDL_CreateTextureFromSurface(renderer, textSurface);
         item.rect = {320 - textSurface->w / 2, yPos, textSurface->w, textSurface->h};
-
         SDL_FreeSurface(textSurface);
-        yPos += spacing;
-
-        items.push_back(item);
-    }
-
-    currentState = MENU_STATE;
-}
-
-void Menu::createPauseMenu() {
-    clearMenuItems();
-
-    std::vector<std::string> menuTexts = {"Resume", "Restart", "Main Menu", "Quit"};
-    SDL_Color normalColor = {255, 255, 255, 255}; // White
-    SDL_Color selectedColor = {255, 255, 0, 255}; // Yellow
-
-    int yPos = 180;
-    const int spacing = 50;
-
-    for (size_t i = 0; i < menuTexts.size(); i++) {
-        MenuItem item;
-        item.text = menuTexts[i];
-        item.selected = (i == selectedIndex);
-
-        SDL_Color textColor = item.selected ? selectedColor : normalColor;
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, item.text.c_str(), textColor);
 
-        if (!textSurface) {
-            std::cerr << "Failed to render menu text! SDL_ttf Error: " << TTF_GetError() << std::endl;
-            continue;
+        if (!item.texture) {
+            std::cerr << "Failed to create menu text texture! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
         }
 
-        item.texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        item.rect = {320 - textSurface->w / 2, yPos, textSurface->w, textSurface->h};
-
-        SDL_FreeSurface(textSurface);
+        menus[state].push_back(item);
         yPos += spacing;
-
-        items.push_back(item);
     }
 
-    currentState = PAUSE_STATE;
+    return true;
 }
 
-void Menu::createGameOverMenu(int score, int highScore) {
-    clearMenuItems();
-    selectedIndex = 0;
-
-    // Create "Game Over" text
-    SDL_Color gameOverColor = {255, 0, 0, 255}; // Red
-    SDL_Surface* gameOverSurface = TTF_RenderText_Blended(titleFont, "Game Over", gameOverColor);
-    if (!gameOverSurface) {
-        std::cerr << "Failed to render game over text! SDL_ttf Error: " << TTF_GetError() << std::endl;
-    } else {
-        gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-        gameOverRect = {320 - gameOverSurface->w / 2, 80, gameOverSurface->w, gameOverSurface->h};
-        SDL_FreeSurface(gameOverSurface);
+void Menu::select(int index) {
+    std::vector<MenuItem>& items = currentItems();
+    if (items.empty()) {
+        return;
     }
 
-    // Create score text
-    SDL_Color scoreColor = {255, 255, 255, 255}; // White
-    std::stringstream scoreText;
-    scoreText << "Score: " << score << "  High Score: " << highScore;
-
-    SDL_Surface* scoreSurface = TTF_RenderText_Blended(font, scoreText.str().c_str(), scoreColor);
-    if (!scoreSurface) {
-        std::cerr << "Failed to render score text! SDL_ttf Error: " << TTF_GetError() << std::endl;
-    } else {
-        finalScoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-        finalScoreRect = {320 - scoreSurface->w / 2, 150, scoreSurface->w, scoreSurface->h};
-        SDL_FreeSurface(scoreSurface);
+    // Only the previously and newly selected items change tint
+    if (selectedIndex >= 0 && selectedIndex < static_cast<int>(items.size())) {
+        SDL_SetTextureColorMod(items[selectedIndex].texture, 255, 255, 255); // White
     }
+    selectedIndex = index;
+    SDL_SetTextureColorMod(items[selectedIndex].texture, 255, 255, 0); // Yellow
+}
 
-    // Create menu options
-    std::vector<std::string> menuTexts = {"Play Again", "Main Menu", "Quit"};
-    SDL_Color normalColor = {255, 255, 255, 255}; // White
-    SDL_Color selectedColor = {255, 255, 0, 255}; // Yellow
-
-    int yPos = 220;
-    const int spacing = 50;
-
-    for (size_t i = 0; i < menuTexts.size(); i++) {
-        MenuItem item;
-        item.text = menuTexts[i];
-        item.selected = (i == selectedIndex);
-
-        SDL_Color textColor = item.selected ? selectedColor : normalColor;
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, item.text.c_str(), textColor);
+void Menu::showMenu(GameState state) {
+    // Clear the tint left over from the last time this menu was shown
+    for (auto& item : menus[state]) {
+        SDL_SetTextureColorMod(item.texture, 255, 255, 255);
+    }
 
-        if (!textSurface) {
-            std::cerr << "Failed to render menu text! SDL_ttf Error: " << TTF_GetError() << std::endl;
-            continue;
-        }
+    currentState = state;
+    selectedIndex = 0;
+    select(0);
+}
 
-        item.texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        item.rect = {320 - textSurface->w / 2, yPos, textSurface->w, textSurface->h};
+void Menu::createMainMenu() {
+    showMenu(MENU_STATE);
+}
 
-        SDL_FreeSurface(textSurface);
-        yPos += spacing;
+void Menu::createPauseMenu() {
+    showMenu(PAUSE_STATE);
+}
 
-        items.push_back(item);
-    }
+void Menu::createGameOverMenu(int score, int highScore, bool won) {
+    // Title and score are drawn from the glyph atlas in render()
+    this->won = won;
+    snprintf(finalScoreText, sizeof(finalScoreText), "Score: %d  High Score: %d", score, highScore);
 
-    currentState = GAME_OVER_STATE;
+    showMenu(GAME_OVER_STATE);
 }
 
 void Menu::handleEvents(SDL_Event& e, GameState& gameState) {
+    std::vector<MenuItem>& items = currentItems();
+
     if (e.type == SDL_KEYDOWN) {
         switch (e.key.keysym.sym) {
             case SDLK_UP:
                 // Move selection up
-                selectedIndex = (selectedIndex > 0) ? selectedIndex - 1 : items.size() - 1;
-
-                // Update selected status
-                for (size_t i = 0; i < items.size(); i++) {
-                    items[i].selected = (i == selectedIndex);
-
-                    // Recreate texture with appropriate color
-                    if (items[i].texture) {
-                        SDL_DestroyTexture(items[i].texture);
-                    }
-
-                    SDL_Color textColor = items[i].selected ? SDL_Color{255, 255, 0, 255} : SDL_Color{255, 255, 255, 255};
-                    SDL_Surface* textSurface = TTF_RenderText_Blended(font, items[i].text.c_str(), textColor);
-                    items[i].texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                    SDL_FreeSurface(textSurface);
+                if (!items.empty()) {
+                    select(selectedIndex > 0 ? selectedIndex - 1 : static_cast<int>(items.size()) - 1);
                 }
                 break;
 
             case SDLK_DOWN:
                 // Move selection down
-                selectedIndex = (selectedIndex < items.size() - 1) ? selectedIndex + 1 : 0;
-
-                // Update selected status
-                for (size_t i = 0; i < items.size(); i++) {
-                    items[i].selected = (i == selectedIndex);
-
-                    // Recreate texture with appropriate color
-                    if (items[i].texture) {
-                        SDL_DestroyTexture(items[i].texture);
-                    }
-
-                    SDL_Color textColor = items[i].selected ? SDL_Color{255, 255, 0, 255} : SDL_Color{255, 255, 255, 255};
-                    SDL_Surface* textSurface = TTF_RenderText_Blended(font, items[i].text.c_str(), textColor);
-                    items[i].texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                    SDL_FreeSurface(textSurface);
+                if (!items.empty()) {
+                    select(selectedIndex < static_cast<int>(items.size()) - 1 ? selectedIndex + 1 : 0);
                 }
                 break;
 
             case SDLK_RETURN:
             case SDLK_SPACE:
                 // Select the current item
+                if (items.empty()) {
+                    break;
+                }
+
                 if (currentState == MENU_STATE) {
                     // Main menu selection
                     if (items[selectedIndex].text == "Play") {
@@ -338,43 +209,46 @@ void Menu::handleEvents(SDL_Event& e, GameState& gameState) {
 void Menu::renderMenuItem(const MenuItem& item) {
     if (item.texture) {
         SDL_RenderCopy(renderer, item.texture, nullptr, &item.rect);
+        drawCalls++;
     }
 }
 
 void Menu::render() {
-    // Render background
-    if (backgroundTexture) {
-        SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);
-    }
+    // Dim the game background that is already on screen
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, nullptr);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    drawCalls++;
 
     // Render title or game over message
     if (currentState == MENU_STATE) {
-        if (titleTexture) {
-            SDL_RenderCopy(renderer, titleTexture, nullptr, &titleRect);
-        }
+        text->drawCentered(titleFont, "Snake Game", 320, 80, SDL_Color{255, 255, 0, 255}); // Yellow
     } else if (currentState == GAME_OVER_STATE) {
-        if (gameOverTexture) {
-            SDL_RenderCopy(renderer, gameOverTexture, nullptr, &gameOverRect);
-        }
-
-        if (finalScoreTexture) {
-            SDL_RenderCopy(renderer, finalScoreTexture, nullptr, &finalScoreRect);
+        if (won) {
+            text->drawCentered(titleFont, "You Win!", 320, 80, SDL_Color{0, 255, 0, 255}); // Green
+        } else {
+            text->drawCentered(titleFont, "Game Over", 320, 80, SDL_Color{255, 0, 0, 255}); // Red
         }
+        text->drawCentered(textFont, finalScoreText, 320, 150, SDL_Color{255, 255, 255, 255});
     } else if (currentState == PAUSE_STATE) {
         // Render "PAUSED" text at the top
-        SDL_Color pauseColor = {255, 255, 0, 255}; // Yellow
-        SDL_Surface* pauseSurface = TTF_RenderText_Blended(titleFont, "PAUSED", pauseColor);
-        if (pauseSurface) {
-            SDL_Texture* pauseTexture = SDL_CreateTextureFromSurface(renderer, pauseSurface);
-            SDL_Rect pauseRect = {320 - pauseSurface->w / 2, 80, pauseSurface->w, pauseSurface->h};
-            SDL_RenderCopy(renderer, pauseTexture, nullptr, &pauseRect);
-            SDL_DestroyTexture(pauseTexture);
-            SDL_FreeSurface(pauseSurface);
-        }
+        text->drawCentered(titleFont, "PAUSED", 320, 80, SDL_Color{255, 255, 0, 255}); // Yellow
     }
+    text->flush();
 
     // Render menu items
-    for (const auto& item : items) {
+    for (const auto& item : currentItems()) {
         renderMenuItem(item);
     }
+
+    // Loading bar while game assets are still decoding in the background
+    if (loadingDone < loadingTotal) {
+        SDL_Rect outline = {220, 440, 200, 12};
+        SDL_Rect fill = {222, 442, 196 * loadingDone / loadingTotal, 8};
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawRect(renderer, &outline);
+        SDL_RenderFillRect(renderer, &fill);
+        drawCalls += 2;
+    }
 }
@@ -6,6 +6,9 @@
 #include <vector>
 #include <string>
 
+#include "TextRenderer.h"
+#include "AssetPack.h"
+
 enum GameState {
     MENU_STATE,
     GAME_STATE,
@@ -13,51 +16,63 @@ enum GameState {
     GAME_OVER_STATE
 };
 
+// Labels are rasterized once in white; the selected item is tinted with
+// SDL_SetTextureColorMod, so changing selection never re-renders text
 struct MenuItem {
     std::string text;
     SDL_Rect rect;
     SDL_Texture* texture;
-    bool selected;
 };
 
 class Menu {
 private:
     SDL_Renderer* renderer;
+    TextRenderer* text;
+    AssetPack* assets;
     TTF_Font* font;
-    TTF_Font* titleFont;
-    std::vector<MenuItem> items;
+    int titleFont; // Font ids in the shared glyph atlas
+    int textFont;
+    // Item lists for MENU_STATE, PAUSE_STATE and GAME_OVER_STATE, built once in init()
+    std::vector<MenuItem> menus[GAME_OVER_STATE + 1];
     int selectedIndex;
-    SDL_Texture* backgroundTexture;
     GameState currentState;
 
-    // Title texture
-    SDL_Texture* titleTexture;
-    SDL_Rect titleRect;
+    // Game over message and score display
+    bool won;
+    char finalScoreText[64];
 
-    // Game over message
-    SDL_Texture* gameOverTexture;
-    SDL_Rect gameOverRect;
+    int drawCalls;
 
-    // Score display for game over screen
-    SDL_Texture* finalScoreTexture;
-    SDL_Rect finalScoreRect;
+    // Background asset loading progress, shown as a bar until done == total
+    int loadingDone;
+    int loadingTotal;
 
     void renderMenuItem(const MenuItem& item);
     void clearMenuItems();
+    bool buildItems(GameState state, const std::vector<std::string>& labels, int yPos, int spacing);
+    std::vector<MenuItem>& currentItems() { return menus[currentState]; }
+    void select(int index);
+    void showMenu(GameState state);
 
 public:
-    Menu(SDL_Renderer* renderer);
+    Menu(SDL_Renderer* renderer, TextRenderer* text, AssetPack* assets);
     ~Menu();
 
+    // Registers the menu's font sizes in the glyph atlas, so it must run
+    // before TextRenderer::build()
     bool init();
     void handleEvents(SDL_Event& e, GameState& gameState);
     void render();
 
     void createMainMenu();
     void createPauseMenu();
-    void createGameOverMenu(int score, int highScore);
+    void createGameOverMenu(int score, int highScore, bool won = false);
 
     GameState getCurrentState() const { return currentState; }
+    int getDrawCalls() const { return drawCalls; }
+    void resetDrawCalls() { drawCalls = 0; }
+    void setLoadingProgress(int done, int total) { loadingDone = done; loadingTotal = total; }
+    int getLoadingDone() const { return loadingDone; }
     void setState(GameState state) { currentState = state; }
 };
 
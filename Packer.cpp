@@ -0,0 +1,197 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+// snake_pack: đóng gói tài nguyên thành một tệp để game ánh xạ thẳng vào bộ nhớ.
+// Ảnh .png được giải mã sẵn sang PACK_PIXEL_FORMAT, âm thanh .wav được chuyển sẵn
+// sang định dạng của bộ trộn, các tệp khác (font) được chép nguyên.
+//
+//   snake_pack assets/assets.pak assets/background.png assets/eat.wav assets/font.ttf ...
+
+namespace {
+
+struct PackItem {
+    PackEntry entry;
+    std::vector<Uint8> bytes;
+};
+
+bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool packImage(const std::string& path, PackItem& item) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cerr << "Không thể tải hình ảnh " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, PACK_PIXEL_FORMAT, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        std::cerr << "Không thể chuyển định dạng " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Ghi từng hàng để bỏ phần đệm cuối hàng của surface
+    int pitch = surface->w * 4;
+    item.bytes.resize(static_cast<size_t>(pitch) * surface->h);
+    for (int y = 0; y < surface->h; y++) {
+        memcpy(&item.bytes[static_cast<size_t>(y) * pitch],
+               static_cast<const Uint8*>(surface->pixels) + y * surface->pitch, pitch);
+    }
+
+    item.entry.type = PACK_IMAGE;
+    item.entry.format = PACK_PIXEL_FORMAT;
+    item.entry.width = surface->w;
+    item.entry.height = surface->h;
+    item.entry.pitch = pitch;
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+bool packSound(const std::string& path, PackItem& item) {
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(path.c_str(), &spec, &buffer, &length)) {
+        std::cerr << "Không thể tải âm thanh " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
+                          PACK_AUDIO_FORMAT, PACK_AUDIO_CHANNELS, PACK_AUDIO_FREQUENCY) < 0) {
+        std::cerr << "Không thể chuyển âm thanh " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+        SDL_FreeWAV(buffer);
+        return false;
+    }
+
+    item.bytes.resize(static_cast<size_t>(length) * cvt.len_mult);
+    memcpy(item.bytes.data(), buffer, length);
+    SDL_FreeWAV(buffer);
+
+    cvt.buf = item.bytes.data();
+    cvt.len = static_cast<int>(length);
+    if (SDL_ConvertAudio(&cvt) < 0) {
+        std::cerr << "Không thể chuyển âm thanh " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    item.bytes.resize(static_cast<size_t>(cvt.len_cvt));
+
+    item.entry.type = PACK_SOUND;
+    item.entry.format = PACK_AUDIO_FORMAT;
+    item.entry.width = PACK_AUDIO_FREQUENCY;
+    item.entry.height = PACK_AUDIO_CHANNELS;
+    return true;
+}
+
+bool packRaw(const std::string& path, PackItem& item) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Không thể mở " << path << std::endl;
+        return false;
+    }
+
+    Uint8 chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        item.bytes.insert(item.bytes.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    item.entry.type = PACK_RAW;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* args[]) {
+    if (argc < 3) {
+        std::cerr << "Cách dùng: snake_pack <gói.pak> <tệp>..." << std::endl;
+        return 1;
+    }
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "SDL không thể khởi tạo! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    std::vector<PackItem> items;
+    for (int i = 2; i < argc; i++) {
+        std::string path = args[i];
+        std::string name = baseName(path);
+        if (name.size() >= PACK_NAME_LENGTH) {
+            std::cerr << "Tên tệp quá dài: " << name << std::endl;
+            return 1;
+        }
+
+        PackItem item;
+        memset(&item.entry, 0, sizeof(item.entry));
+        memcpy(item.entry.name, name.c_str(), name.size());
+
+        bool packed;
+        if (endsWith(name, ".png")) {
+            packed = packImage(path, item);
+        } else if (endsWith(name, ".wav")) {
+            packed = packSound(path, item);
+        } else {
+            packed = packRaw(path, item);
+        }
+        if (!packed) {
+            return 1;
+        }
+        items.push_back(item);
+    }
+
+    // Đặt dữ liệu sau bảng mục lục, mỗi mục căn lề để đọc điểm ảnh thẳng từ vùng ánh xạ
+    PackHeader header;
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<Uint32>(items.size());
+
+    size_t offset = sizeof(PackHeader) + items.size() * sizeof(PackEntry);
+    for (PackItem& item : items) {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        item.entry.offset = static_cast<Uint32>(offset);
+        item.entry.size = static_cast<Uint32>(item.bytes.size());
+        offset += item.bytes.size();
+    }
+
+    FILE* out = fopen(args[1], "wb");
+    if (!out) {
+        std::cerr << "Không thể ghi " << args[1] << std::endl;
+        return 1;
+    }
+
+    fwrite(&header, sizeof(header), 1, out);
+    for (const PackItem& item : items) {
+        fwrite(&item.entry, sizeof(item.entry), 1, out);
+    }
+
+    const Uint8 zeros[PACK_ALIGNMENT] = {};
+    size_t written = sizeof(PackHeader) + items.size() * sizeof(PackEntry);
+    for (const PackItem& item : items) {
+        fwrite(zeros, 1, item.entry.offset - written, out);
+        fwrite(item.bytes.data(), 1, item.bytes.size(), out);
+        written = item.entry.offset + item.bytes.size();
+        std::cout << item.entry.name << ": " << item.bytes.size() << " byte" << std::endl;
+    }
+
+    bool ok = fclose(out) == 0;
+    IMG_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "Profiler.h"
+
+#ifdef SNAKE_PROFILE
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    Uint64 start;
+    Uint64 end;
+    SDL_threadID thread;
+};
+
+// Khóa cả bảng giai đoạn lẫn danh sách sự kiện: luồng tải tài nguyên cũng ghi vào
+SDL_mutex* mutex = SDL_CreateMutex();
+bool tracing = false;
+std::string tracePath;
+std::vector<TraceEvent> events;
+Uint64 traceStart = 0;
+
+}
+
+Profiler::PhaseStat Profiler::phases[Profiler::MAX_PHASES];
+double Profiler::currentMs[Profiler::MAX_PHASES];
+int Profiler::phaseCount = 0;
+double Profiler::frameMs[Profiler::FRAME_HISTORY];
+int Profiler::frameCount = 0;
+int Profiler::ticks = 0;
+double Profiler::ticksPerSecond = 0;
+Uint64 Profiler::secondStart = 0;
+
+void Profiler::record(const char* name, Uint64 start, Uint64 end) {
+    double ms = (end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    SDL_LockMutex(mutex);
+
+    // Tên là chuỗi hằng nên so con trỏ là đủ
+    int phase = 0;
+    while (phase < phaseCount && phases[phase].name != name) {
+        phase++;
+    }
+    if (phase == phaseCount && phaseCount < MAX_PHASES) {
+        phases[phase].name = name;
+        phases[phase].lastMs = 0;
+        currentMs[phase] = 0;
+        phaseCount++;
+    }
+    if (phase < phaseCount) {
+        currentMs[phase] += ms;
+    }
+
+    if (tracing) {
+        TraceEvent event = {name, start, end, SDL_ThreadID()};
+        events.push_back(event);
+    }
+
+    SDL_UnlockMutex(mutex);
+}
+
+void Profiler::endFrame(Uint64 frameCounts) {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    frameMs[frameCount % FRAME_HISTORY] = frameCounts * 1000.0 / frequency;
+    frameCount++;
+
+    SDL_LockMutex(mutex);
+    for (int i = 0; i < phaseCount; i++) {
+        phases[i].lastMs = currentMs[i];
+        currentMs[i] = 0;
+    }
+    SDL_UnlockMutex(mutex);
+
+    // Số bước mô phỏng trong mỗi giây, cập nhật một lần mỗi giây
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (secondStart == 0) {
+        secondStart = now;
+    } else if (now - secondStart >= frequency) {
+        ticksPerSecond = ticks * static_cast<double>(frequency) / (now - secondStart);
+        ticks = 0;
+        secondStart = now;
+    }
+}
+
+int Profiler::getFrameCount() {
+    return std::min(frameCount, static_cast<int>(FRAME_HISTORY));
+}
+
+double Profiler::getFrameMs(int age) {
+    return frameMs[(frameCount - 1 - age + FRAME_HISTORY) % FRAME_HISTORY];
+}
+
+double Profiler::getLastFrameMs() {
+    return frameCount > 0 ? getFrameMs(0) : 0;
+}
+
+double Profiler::getPercentileMs(double p) {
+    int count = getFrameCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    double sorted[FRAME_HISTORY];
+    std::copy(frameMs, frameMs + count, sorted);
+    std::sort(sorted, sorted + count);
+    return sorted[static_cast<int>(p * (count - 1) + 0.5)];
+}
+
+void Profiler::startTrace(const char* path) {
+    SDL_LockMutex(mutex);
+    tracing = true;
+    tracePath = path;
+    events.clear();
+    events.reserve(1 << 16);
+    traceStart = SDL_GetPerformanceCounter();
+    SDL_UnlockMutex(mutex);
+}
+
+bool Profiler::writeTrace() {
+    SDL_LockMutex(mutex);
+    if (!tracing) {
+        SDL_UnlockMutex(mutex);
+        return true;
+    }
+    tracing = false;
+
+    FILE* file = fopen(tracePath.c_str(), "w");
+    if (!file) {
+        std::cerr << "Không thể ghi trace " << tracePath << std::endl;
+        SDL_UnlockMutex(mutex);
+        return false;
+    }
+
+    // Định dạng trace_event: sự kiện "X" (complete), thời gian tính bằng micro giây
+    double toMicros = 1000000.0 / SDL_GetPerformanceFrequency();
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event.name, static_cast<unsigned long>(event.thread),
+                (event.start - traceStart) * toMicros, (event.end - event.start) * toMicros,
+                i + 1 < events.size() ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    bool ok = fclose(file) == 0;
+    std::cout << "Đã ghi " << events.size() << " sự kiện vào " << tracePath << std::endl;
+    events.clear();
+    SDL_UnlockMutex(mutex);
+    return ok;
+}
+
+#endif // SNAKE_PROFILE
@@ -0,0 +1,72 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL.h>
+
+// Bộ đo thời gian theo từng giai đoạn của khung hình, chỉ có khi biên dịch
+// với SNAKE_PROFILE (target Profile). Bản thường thì PROFILE_SCOPE là rỗng
+// và lớp Profiler không được biên dịch, nên không tốn gì cả.
+#ifdef SNAKE_PROFILE
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// name phải là chuỗi hằng (được giữ bằng con trỏ)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+class Profiler {
+public:
+    static const int MAX_PHASES = 16;
+    static const int FRAME_HISTORY = 240;
+
+    struct PhaseStat {
+        const char* name;
+        double lastMs; // Tổng thời gian trong khung hình trước
+    };
+
+    // Ghi một đoạn thời gian [start, end] (SDL_GetPerformanceCounter); gọi được từ mọi luồng
+    static void record(const char* name, Uint64 start, Uint64 end);
+    // Kết thúc một khung hình dài frameCounts đơn vị bộ đếm
+    static void endFrame(Uint64 frameCounts);
+    static void countTick() { ticks++; }
+
+    // Ghi mọi sự kiện để xuất ra tệp JSON trace_event (mở bằng chrome://tracing hoặc Perfetto)
+    static void startTrace(const char* path);
+    static bool writeTrace();
+
+    // Số liệu cho lớp phủ
+    static double getPercentileMs(double p);
+    static double getLastFrameMs();
+    static double getTicksPerSecond() { return ticksPerSecond; }
+    static int getFrameCount();
+    static double getFrameMs(int age); // age = 0 là khung hình gần nhất
+    static int getPhaseCount() { return phaseCount; }
+    static const PhaseStat& getPhase(int i) { return phases[i]; }
+
+private:
+    static PhaseStat phases[MAX_PHASES];
+    static double currentMs[MAX_PHASES];
+    static int phaseCount;
+    static double frameMs[FRAME_HISTORY];
+    static int frameCount;
+    static int ticks;
+    static double ticksPerSecond;
+    static Uint64 secondStart;
+};
+
+class ProfileScope {
+private:
+    const char* name;
+    Uint64 start;
+
+public:
+    explicit ProfileScope(const char* name) : name(name), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { Profiler::record(name, start, SDL_GetPerformanceCounter()); }
+};
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif // SNAKE_PROFILE
+
+#endif // PROFILER_H
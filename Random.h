@@ -0,0 +1,50 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Bộ sinh số ngẫu nhiên PCG32 (XSH-RR): 16 byte trạng thái, mỗi mô phỏng giữ
+// một bộ riêng nên các ván chạy song song trên nhiều luồng không ảnh hưởng
+// nhau và luôn lặp lại được theo seed. Cùng seed nhưng khác stream cho hai dãy độc lập.
+class Random {
+private:
+    uint64_t state;
+    uint64_t increment; // Luôn lẻ, xác định stream
+
+public:
+    Random() { seed(1); }
+    explicit Random(uint64_t seedValue, uint64_t stream = 0) { seed(seedValue, stream); }
+
+    void seed(uint64_t seedValue, uint64_t stream = 0) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        next();
+        state += seedValue;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Số nguyên đều trong [0, bound), bound > 0. Dùng phép nhân của Lemire thay
+    // cho % (chậm và lệch); chỉ phải rút lại với xác suất bound / 2^32.
+    uint32_t nextBelow(uint32_t bound) {
+        uint64_t product = static_cast<uint64_t>(next()) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = static_cast<uint64_t>(next()) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+};
+
+#endif // RANDOM_H
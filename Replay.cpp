@@ -0,0 +1,241 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char REPLAY_MAGIC[8] = {'S', 'N', 'K', 'R', 'P', 'L', '1', '\0'};
+// 2: mồi sinh bằng PCG32 thay cho LCG, 3: kích thước thế giới 32 bit,
+// 4: cấm quay đầu so với hướng vừa đi thay vì hướng vừa đặt
+const uint32_t REPLAY_VERSION = 4;
+const size_t REPLAY_HEADER_SIZE = 8 + 4 + 4 + 2 + 4 * 2 + 4 + 4 + 8 + 4;
+
+void putBytes(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Đọc tuần tự có kiểm tra biên; sau khi hỏng mọi lần đọc đều trả về 0
+class Reader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+public:
+    Reader(const uint8_t* data, size_t size) : data(data), size(size), pos(0), ok(true) {}
+
+    uint64_t bytes(int count) {
+        if (!ok || size - pos < static_cast<size_t>(count)) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value |= static_cast<uint64_t>(data[pos++]) << (i * 8);
+        }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint64_t byte = bytes(1);
+            value |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    bool isOk() const { return ok; }
+};
+
+}
+
+Replay::Replay()
+    : seed(0), gridSize(0), worldWidth(0), worldHeight(0),
+      finalTick(0), finalScore(0), finalHash(0) {
+}
+
+void Replay::begin(const GameSim& sim, uint32_t seed) {
+    this->seed = seed;
+    gridSize = sim.getGridSize();
+    worldWidth = sim.getWorldWidth();
+    worldHeight = sim.getWorldHeight();
+    inputs.clear();
+    finish(sim);
+}
+
+void Replay::record(const GameSim& sim, Direction direction) {
+    ReplayInput input;
+    input.tick = static_cast<uint32_t>(sim.getTick());
+    input.direction = direction;
+    inputs.push_back(input);
+}
+
+void Replay::finish(const GameSim& sim) {
+    finalTick = static_cast<uint32_t>(sim.getTick());
+    finalScore = static_cast<uint32_t>(sim.getScore());
+    finalHash = sim.getStateHash();
+}
+
+void Replay::serialize(std::vector<uint8_t>& out) const {
+    out.assign(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    putBytes(out, REPLAY_VERSION, 4);
+    putBytes(out, seed, 4);
+    putBytes(out, static_cast<uint64_t>(gridSize), 2);
+    putBytes(out, static_cast<uint64_t>(worldWidth), 4);
+    putBytes(out, static_cast<uint64_t>(worldHeight), 4);
+    putBytes(out, finalTick, 4);
+    putBytes(out, finalScore, 4);
+    putBytes(out, finalHash, 8);
+    putBytes(out, inputs.size(), 4);
+
+    // Hầu hết các lần đổi hướng cách nhau dưới 32 bước nên chỉ tốn một byte
+    uint32_t previousTick = 0;
+    for (const ReplayInput& input : inputs) {
+        putVarint(out, (static_cast<uint64_t>(input.tick - previousTick) << 2) | input.direction);
+        previousTick = input.tick;
+    }
+}
+
+bool Replay::deserialize(const uint8_t* data, size_t size) {
+    if (size < REPLAY_HEADER_SIZE || memcmp(data, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return false;
+    }
+
+    Reader reader(data + sizeof(REPLAY_MAGIC), size - sizeof(REPLAY_MAGIC));
+    if (reader.bytes(4) != REPLAY_VERSION) {
+        return false;
+    }
+    seed = static_cast<uint32_t>(reader.bytes(4));
+    gridSize = static_cast<int>(reader.bytes(2));
+    uint64_t width = reader.bytes(4);
+    uint64_t height = reader.bytes(4);
+    finalTick = static_cast<uint32_t>(reader.bytes(4));
+    finalScore = static_cast<uint32_t>(reader.bytes(4));
+    finalHash = reader.bytes(8);
+    uint64_t inputCount = reader.bytes(4);
+
+    // Không tin kích thước lạ trong tệp gửi lên
+    if (gridSize <= 0 || width < static_cast<uint64_t>(gridSize) || height < static_cast<uint64_t>(gridSize) ||
+        (width / gridSize) * (height / gridSize) > static_cast<uint64_t>(MAX_CELLS) ||
+        width > 0x7FFFFFFF || height > 0x7FFFFFFF || inputCount > size) {
+        return false;
+    }
+    worldWidth = static_cast<int>(width);
+    worldHeight = static_cast<int>(height);
+
+    inputs.clear();
+    inputs.reserve(static_cast<size_t>(inputCount));
+    uint64_t tick = 0;
+    for (uint64_t i = 0; i < inputCount; i++) {
+        uint64_t packed = reader.varint();
+        tick += packed >> 2;
+        if (tick > finalTick) {
+            return false;
+        }
+
+        ReplayInput input;
+        input.tick = static_cast<uint32_t>(tick);
+        input.direction = static_cast<Direction>(packed & 3);
+        inputs.push_back(input);
+    }
+
+    return reader.isOk();
+}
+
+bool Replay::save(const char* path) const {
+    std::vector<uint8_t> bytes;
+    serialize(bytes);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool Replay::load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    return deserialize(bytes.data(), bytes.size());
+}
+
+ReplayPlayer::ReplayPlayer()
+    : replay(nullptr), nextInput(0) {
+}
+
+void ReplayPlayer::start(const Replay& replay, GameSim& sim) {
+    this->replay = &replay;
+    nextInput = 0;
+    sim.reset(replay.getSeed());
+}
+
+void ReplayPlayer::applyInputs(GameSim& sim) {
+    // Giữ đúng thứ tự các lần setDirection trong cùng một bước: lần sau ghi đè lần trước
+    const std::vector<ReplayInput>& inputs = replay->getInputs();
+    uint32_t tick = static_cast<uint32_t>(sim.getTick());
+    while (nextInput < inputs.size() && inputs[nextInput].tick <= tick) {
+        sim.setDirection(inputs[nextInput].direction);
+        nextInput++;
+    }
+}
+
+StepResult ReplayPlayer::step(GameSim& sim) {
+    applyInputs(sim);
+    return sim.step(sim.getDirection());
+}
+
+void ReplayPlayer::seek(GameSim& sim, uint32_t tick) {
+    if (tick < static_cast<uint32_t>(sim.getTick())) {
+        start(*replay, sim);
+    }
+    while (static_cast<uint32_t>(sim.getTick()) < tick && !atEnd(sim)) {
+        step(sim);
+    }
+}
+
+bool ReplayPlayer::atEnd(const GameSim& sim) const {
+    return sim.isOver() || static_cast<uint32_t>(sim.getTick()) >= replay->getFinalTick();
+}
+
+bool ReplayPlayer::verify(const Replay& replay) {
+    GameSim sim(replay.getGridSize(), replay.getWorldWidth(), replay.getWorldHeight());
+    ReplayPlayer player;
+    player.start(replay, sim);
+    while (!player.atEnd(sim)) {
+        player.step(sim);
+    }
+    // Ván bị bỏ dở có thể có lần đổi hướng sau bước cuối cùng
+    player.applyInputs(sim);
+
+    return static_cast<uint32_t>(sim.getTick()) == replay.getFinalTick() &&
+           static_cast<uint32_t>(sim.getScore()) == replay.getFinalScore() &&
+           sim.getStateHash() == replay.getFinalHash();
+}
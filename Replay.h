@@ -0,0 +1,86 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameSim.h"
+
+// Một lần đổi hướng có hiệu lực, xảy ra khi GameSim đã chạy `tick` bước
+struct ReplayInput {
+    uint32_t tick;
+    Direction direction;
+};
+
+// Bản ghi một ván: seed, kích thước bàn chơi, các lần đổi hướng theo bước
+// và băm trạng thái cuối. Vì GameSim tất định, chừng đó đủ để chơi lại y hệt.
+//
+// Định dạng tệp (.snr, little-endian):
+//   "SNKRPL1\0" | version u32 | seed u32 | gridSize u16 | width, height u32
+//   | finalTick u32 | finalScore u32 | finalHash u64 | inputCount u32
+//   | mỗi input một varint LEB128 của (số bước kể từ input trước << 2 | hướng)
+class Replay {
+private:
+    uint32_t seed;
+    int gridSize;
+    int worldWidth;
+    int worldHeight;
+    std::vector<ReplayInput> inputs;
+    uint32_t finalTick;
+    uint32_t finalScore;
+    uint64_t finalHash;
+
+public:
+    // Bàn chơi lớn nhất có replay (1024x1024 ô). Thấp hơn nhiều so với
+    // GameSim::MAX_CELLS vì tệp .snr có thể do người khác gửi lên: một tệp vài
+    // chục byte không được bắt verify cấp phát bảng chiếm chỗ hàng trăm MB.
+    static const int MAX_CELLS = 1 << 20;
+
+    Replay();
+
+    // Bắt đầu ghi một ván mới của sim (gọi ngay sau sim.reset(seed))
+    void begin(const GameSim& sim, uint32_t seed);
+    // Ghi một lần setDirection đã làm đổi hướng của sim
+    void record(const GameSim& sim, Direction direction);
+    // Ghi trạng thái cuối để kiểm tra khi chơi lại
+    void finish(const GameSim& sim);
+
+    bool save(const char* path) const;
+    bool load(const char* path);
+    void serialize(std::vector<uint8_t>& out) const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+    uint32_t getSeed() const { return seed; }
+    int getGridSize() const { return gridSize; }
+    int getWorldWidth() const { return worldWidth; }
+    int getWorldHeight() const { return worldHeight; }
+    const std::vector<ReplayInput>& getInputs() const { return inputs; }
+    uint32_t getFinalTick() const { return finalTick; }
+    uint32_t getFinalScore() const { return finalScore; }
+    uint64_t getFinalHash() const { return finalHash; }
+};
+
+// Chạy lại một Replay trên một GameSim có cùng kích thước
+class ReplayPlayer {
+private:
+    const Replay* replay;
+    size_t nextInput;
+
+    void applyInputs(GameSim& sim);
+
+public:
+    ReplayPlayer();
+
+    void start(const Replay& replay, GameSim& sim);
+    // Áp mọi lần đổi hướng của bước hiện tại rồi chạy một bước
+    StepResult step(GameSim& sim);
+    // Tới bước tick; lùi lại thì mô phỏng lại từ đầu
+    void seek(GameSim& sim, uint32_t tick);
+    bool atEnd(const GameSim& sim) const;
+
+    // Chạy hết replay và so điểm, số bước và băm trạng thái cuối
+    static bool verify(const Replay& replay);
+};
+
+#endif // REPLAY_H
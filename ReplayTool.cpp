@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Replay.h"
+#include "ThreadPool.h"
+
+// snake_replay: mô phỏng lại các tệp replay (.snr) không cần cửa sổ, với tốc độ
+// tối đa trên mọi lõi CPU, và kiểm tra điểm cùng băm trạng thái cuối của từng tệp.
+// Xem lại bằng hình thì dùng game: snake --replay file.snr
+//
+//   snake_replay [--threads 0] [--quiet] file.snr...
+
+namespace {
+
+enum VerifyStatus {
+    VERIFY_OK,
+    VERIFY_MISMATCH,
+    VERIFY_UNREADABLE
+};
+
+struct VerifyResult {
+    VerifyStatus status;
+    uint32_t score;
+    uint32_t ticks;
+};
+
+}
+
+int main(int argc, char* args[]) {
+    int threads = 0;
+    bool quiet = false;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(args[++i]);
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        std::cerr << "Cách dùng: snake_replay [--threads N] [--quiet] file.snr..." << std::endl;
+        return 1;
+    }
+
+    // Kết quả ghi theo chỉ số tệp nên thứ tự in không phụ thuộc số luồng
+    std::vector<VerifyResult> results(files.size());
+    ThreadPool pool(threads);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pool.parallelFor(static_cast<int>(files.size()), [&](int index, int) {
+        VerifyResult& result = results[index];
+        Replay replay;
+        if (!replay.load(files[index].c_str())) {
+            result.status = VERIFY_UNREADABLE;
+            result.score = 0;
+            result.ticks = 0;
+            return;
+        }
+
+        result.status = ReplayPlayer::verify(replay) ? VERIFY_OK : VERIFY_MISMATCH;
+        result.score = replay.getFinalScore();
+        result.ticks = replay.getFinalTick();
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed = 0;
+    long long totalTicks = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        const VerifyResult& result = results[i];
+        totalTicks += result.ticks;
+        if (result.status != VERIFY_OK) {
+            failed++;
+        }
+
+        if (!quiet || result.status != VERIFY_OK) {
+            const char* status = result.status == VERIFY_OK ? "OK"
+                               : result.status == VERIFY_MISMATCH ? "SAI" : "HỎNG";
+            std::cout << files[i] << ": " << status << " (điểm " << result.score
+                      << ", " << result.ticks << " bước)" << std::endl;
+        }
+    }
+
+    std::cout << files.size() << " replay, " << failed << " lỗi, "
+              << static_cast<long long>(files.size() / seconds) << " replay/s, "
+              << static_cast<long long>(totalTicks / seconds) << " bước/s, "
+              << pool.getThreadCount() << " luồng" << std::endl;
+
+    return failed == 0 ? 0 : 1;
+}
@@ -1,68 +1,46 @@
 #include "Snake.h"
-#include <iostream>
-#include <SDL_image.h>
 
 
-Snake::Snake(SDL_Renderer* renderer, int gridSize)
-    : renderer(renderer), gridSize(gridSize), direction(RIGHT),
-      headTexture(nullptr), bodyTexture(nullptr) {
+Snake::Snake(int gridSize, int worldWidth, int worldHeight)
+    : direction(RIGHT), movedDirection(RIGHT), gridSize(gridSize) {
+    // Rắn dài nhất phủ kín bàn chơi, cộng một ô cho đoạn đuôi nhân đôi khi grow().
+    // Bàn chơi lớn thì chỉ cấp phát trước một phần, bộ đệm tự lớn dần theo rắn.
+    int cells = (worldWidth / gridSize) * (worldHeight / gridSize);
+    segments.reset(cells < MAX_RESERVED_SEGMENTS ? cells + 1 : MAX_RESERVED_SEGMENTS);
+    grid.resize(worldWidth / gridSize, worldHeight / gridSize);
 }
 
-Snake::~Snake() {
-    if (headTexture) {
-        SDL_DestroyTexture(headTexture);
-    }
-    if (bodyTexture) {
-        SDL_DestroyTexture(bodyTexture);
-    }
+void Snake::pushHead(const SnakeSegment& segment) {
+    segments.pushFront(segment);
+    grid.add(segment.x / gridSize, segment.y / gridSize);
 }
 
-bool Snake::loadTextures() {
-    // Tải hình ảnh đầu rắn
-    SDL_Surface* headSurface = IMG_Load("assets/snake_head.png");
-    if (!headSurface) {
-        std::cerr << "Không thể tải hình ảnh đầu rắn! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    headTexture = SDL_CreateTextureFromSurface(renderer, headSurface);
-    SDL_FreeSurface(headSurface);
-
-    if (!headTexture) {
-        std::cerr << "Không thể tạo texture đầu rắn! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    // Tải hình ảnh thân rắn
-    SDL_Surface* bodySurface = IMG_Load("assets/snake_body.png");
-    if (!bodySurface) {
-        std::cerr << "Không thể tải hình ảnh thân rắn! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    bodyTexture = SDL_CreateTextureFromSurface(renderer, bodySurface);
-    SDL_FreeSurface(bodySurface);
-
-    if (!bodyTexture) {
-        std::cerr << "Không thể tạo texture thân rắn! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
+void Snake::pushTail(const SnakeSegment& segment) {
+    segments.pushBack(segment);
+    grid.add(segment.x / gridSize, segment.y / gridSize);
+}
 
-    return true;
+void Snake::popTail() {
+    const SnakeSegment& tail = segments.back();
+    grid.remove(tail.x / gridSize, tail.y / gridSize);
+    segments.popBack();
 }
 
 void Snake::init(int startX, int startY) {
     segments.clear();
+    grid.clear();
 
     // Tạo rắn ban đầu với 3 đoạn
     for (int i = 0; i < 3; i++) {
         SnakeSegment segment;
         segment.x = startX - i * gridSize;
         segment.y = startY;
-        segments.push_back(segment);
+        pushTail(segment);
     }
 
+    lastTail = segments.back();
     direction = RIGHT;
+    movedDirection = RIGHT;
 }
 
 void Snake::move() {
@@ -85,57 +63,28 @@ void Snake::move() {
             break;
     }
 
-    // Thêm đầu mới
-    segments.insert(segments.begin(), newHead);
+    // Xóa đuôi trước để bộ đệm vòng không bao giờ tràn
+    // (đuôi sẽ được thêm lại nếu rắn ăn mồi, xem grow())
+    lastTail = segments.back();
+    popTail();
 
-    // Xóa đuôi (sẽ không xóa nếu rắn ăn mồi, được xử lý trong Game::update())
-    segments.pop_back();
+    // Thêm đầu mới
+    pushHead(newHead);
+    movedDirection = direction;
 }
 
 void Snake::grow() {
     // Rắn đã di chuyển, không xóa đuôi (tức là dài ra)
-    segments.push_back(segments.back());
-}
-
-void Snake::render() {
-    SDL_Rect destRect = {0, 0, gridSize, gridSize};
-
-    // Render thân rắn
-    for (size_t i = 1; i < segments.size(); i++) {
-        destRect.x = segments[i].x;
-        destRect.y = segments[i].y;
-        SDL_RenderCopy(renderer, bodyTexture, nullptr, &destRect);
-    }
-
-    // Render đầu rắn với góc quay phù hợp
-    destRect.x = segments[0].x;
-    destRect.y = segments[0].y;
-
-    double angle = 0;
-    switch (direction) {
-        case UP:
-            angle = 0;
-            break;
-        case RIGHT:
-            angle = 90;
-            break;
-        case DOWN:
-            angle = 180;
-            break;
-        case LEFT:
-            angle = 270;
-            break;
-    }
-
-    SDL_RenderCopyEx(renderer, headTexture, nullptr, &destRect, angle, nullptr, SDL_FLIP_NONE);
+    pushTail(segments.back());
 }
 
 void Snake::setDirection(Direction newDir) {
-    // Ngăn chặn di chuyển ngược lại
-    if ((direction == UP && newDir != DOWN) ||
-        (direction == DOWN && newDir != UP) ||
-        (direction == LEFT && newDir != RIGHT) ||
-        (direction == RIGHT && newDir != LEFT)) {
+    // Ngăn chặn di chuyển ngược lại: so với hướng của lần move() gần nhất, không phải
+    // hướng vừa đặt, nên hai lần đổi hướng giữa hai bước không quay được đầu vào cổ
+    if ((movedDirection == UP && newDir != DOWN) ||
+        (movedDirection == DOWN && newDir != UP) ||
+        (movedDirection == LEFT && newDir != RIGHT) ||
+        (movedDirection == RIGHT && newDir != LEFT)) {
         direction = newDir;
     }
 }
@@ -143,12 +92,14 @@ void Snake::setDirection(Direction newDir) {
 bool Snake::checkSelfCollision() const {
     const SnakeSegment& head = segments.front();
 
-    // Kiểm tra va chạm với thân (bắt đầu từ phần tử thứ 3 để tránh va chạm giả)
-    for (size_t i = 3; i < segments.size(); i++) {
+    // Kiểm tra va chạm với thân (bỏ qua 3 phần tử đầu để tránh va chạm giả):
+    // lấy số đoạn trên ô của đầu rồi trừ đi các đoạn 0..2 cũng nằm ở đó
+    int others = grid.count(head.x / gridSize, head.y / gridSize) - 1;
+    for (size_t i = 1; i < 3 && i < segments.size(); i++) {
         if (head.x == segments[i].x && head.y == segments[i].y) {
-            return true;
+            others--;
         }
     }
 
-    return false;
+    return others > 0;
 }
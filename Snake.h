@@ -1,40 +1,44 @@
 #ifndef SNAKE_H
 #define SNAKE_H
 
-#include <SDL.h>
-#include <vector>
+#include "SnakeBody.h"
+#include "Grid.h"
 
 enum Direction {
     UP, DOWN, LEFT, RIGHT
 };
 
-struct SnakeSegment {
-    int x,y;
-};
-
 class Snake {
 private:
-    std::vector<SnakeSegment> segments;
+    SnakeBody segments;
+    Grid grid;
     Direction direction;
-    SDL_Texture* headTexture;
-    SDL_Texture* bodyTexture;
-    SDL_Renderer* renderer;
+    Direction movedDirection; // Hướng của lần move() gần nhất
+    SnakeSegment lastTail; // Đoạn đuôi vừa bị bỏ ở lần move() gần nhất
     int gridSize;
 
+    void pushHead(const SnakeSegment& segment);
+    void pushTail(const SnakeSegment& segment);
+    void popTail();
+
 public:
-    Snake(SDL_Renderer* renderer, int gridSize);
-    ~Snake();
+    static const int MAX_RESERVED_SEGMENTS = 1 << 16;
+
+    Snake(int gridSize, int worldWidth, int worldHeight);
 
-    bool loadTextures();
     void init(int startX, int startY);
     void move();
     void grow();
-    void render();
     void setDirection(Direction newDir);
 
     Direction getDirection() const {return direction;}
     SnakeSegment getHead() const {return segments.front();}
-    std::vector<SnakeSegment>& getSegments() {return segments;}
+    const SnakeBody& getSegments() const {return segments;}
+    SnakeSegment getLastTail() const {return lastTail;}
+    const Grid& getGrid() const {return grid;}
+
+    // Tọa độ điểm ảnh (x, y) có đang bị thân rắn chiếm không, O(1)
+    bool isOccupied(int x, int y) const {return grid.isOccupied(x / gridSize, y / gridSize);}
 
     bool checkSelfCollision() const;
 };
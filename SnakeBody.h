@@ -0,0 +1,99 @@
+#ifndef SNAKEBODY_H
+#define SNAKEBODY_H
+
+#include <vector>
+#include <cstddef>
+
+struct SnakeSegment {
+    int x,y;
+};
+
+// Thân rắn lưu trong bộ đệm vòng. Thêm đầu, bỏ đuôi và thêm đuôi đều là O(1);
+// bộ đệm chỉ cấp phát lại (gấp đôi) khi đầy, nên với dung lượng ban đầu đủ lớn
+// thì không bao giờ cấp phát trong lúc chơi.
+class SnakeBody {
+private:
+    std::vector<SnakeSegment> ring;
+    size_t head;  // Vị trí vật lý của phần tử đầu tiên (đầu rắn)
+    size_t count;
+
+    size_t physical(size_t i) const {
+        size_t p = head + i;
+        return p >= ring.size() ? p - ring.size() : p;
+    }
+
+    // Gấp đôi dung lượng, xếp lại các đoạn theo thứ tự từ đầu
+    void expand() {
+        std::vector<SnakeSegment> larger(ring.size() > 0 ? ring.size() * 2 : 16);
+        for (size_t i = 0; i < count; i++) {
+            larger[i] = (*this)[i];
+        }
+        ring.swap(larger);
+        head = 0;
+    }
+
+public:
+    class const_iterator {
+    private:
+        const SnakeBody* body;
+        size_t index;
+
+    public:
+        const_iterator(const SnakeBody* body, size_t index) : body(body), index(index) {}
+
+        const SnakeSegment& operator*() const { return (*body)[index]; }
+        const SnakeSegment* operator->() const { return &(*body)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    };
+
+    SnakeBody() : head(0), count(0) {}
+
+    // Cấp phát trước dung lượng ban đầu và làm rỗng thân rắn
+    void reset(size_t capacity) {
+        ring.assign(capacity, SnakeSegment{0, 0});
+        head = 0;
+        count = 0;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    void pushFront(const SnakeSegment& segment) {
+        if (count == ring.size()) {
+            expand();
+        }
+        head = (head == 0) ? ring.size() - 1 : head - 1;
+        ring[head] = segment;
+        count++;
+    }
+
+    void pushBack(const SnakeSegment& segment) {
+        if (count == ring.size()) {
+            expand();
+        }
+        ring[physical(count)] = segment;
+        count++;
+    }
+
+    void popBack() {
+        count--;
+    }
+
+    const SnakeSegment& operator[](size_t i) const { return ring[physical(i)]; }
+    const SnakeSegment& front() const { return ring[head]; }
+    const SnakeSegment& back() const { return ring[physical(count - 1)]; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return ring.size(); }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == ring.size(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+};
+
+#endif // SNAKEBODY_H
@@ -0,0 +1,276 @@
+#include "SnakeEnv.h"
+#include "BatchSim.h"
+#include <climits>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// BatchSim đọc hành động như mảng int32_t
+static_assert(sizeof(Direction) == sizeof(int32_t), "Direction must be 32 bits");
+
+struct SnakeEnv {
+    BatchSim sim;
+    int cells;
+
+    int obsType;
+    float* obs;
+    float* rewards;
+    uint8_t* dones;
+
+    // Ô của đầu, đuôi và mồi trước bước hiện tại, để chỉ vẽ lại các ô thay đổi
+    std::vector<int32_t> prevHead;
+    std::vector<int32_t> prevTail;
+    std::vector<int32_t> prevFood;
+
+    SnakeEnv(int count, int cols, int rows)
+        : sim(count, cols, rows), cells(cols * rows),
+          obsType(SNAKE_ENV_OBS_PLANES), obs(nullptr), rewards(nullptr), dones(nullptr),
+          prevHead(count), prevTail(count), prevFood(count) {
+    }
+};
+
+namespace {
+
+const int PLANE_HEAD = 0;
+const int PLANE_BODY = 1;
+const int PLANE_FOOD = 2;
+
+int obsSize(const SnakeEnv* env, int obsType) {
+    return obsType == SNAKE_ENV_OBS_PLANES ? SNAKE_ENV_PLANE_COUNT * env->cells : SNAKE_ENV_FEATURE_COUNT;
+}
+
+float* planeOf(SnakeEnv* env, int index, int plane) {
+    return env->obs + static_cast<size_t>(index) * SNAKE_ENV_PLANE_COUNT * env->cells + static_cast<size_t>(plane) * env->cells;
+}
+
+int foodCell(const BatchSim& sim, int index) {
+    return sim.getFoodY()[index] * sim.getCols() + sim.getFoodX()[index];
+}
+
+void drawPlanes(SnakeEnv* env, int index) {
+    const BatchSim& sim = env->sim;
+    float* head = planeOf(env, index, PLANE_HEAD);
+    float* body = planeOf(env, index, PLANE_BODY);
+    float* food = planeOf(env, index, PLANE_FOOD);
+    memset(head, 0, SNAKE_ENV_PLANE_COUNT * env->cells * sizeof(float));
+
+    int length = sim.getLengths()[index];
+    for (int i = 0; i < length; i++) {
+        body[sim.getSegment(index, i)] = 1.0f;
+    }
+    head[sim.getSegment(index, 0)] = 1.0f;
+    food[foodCell(sim, index)] = 1.0f;
+}
+
+// Sau một bước bình thường chỉ có đầu cũ, đầu mới, ô đuôi vừa rời và mồi là đổi
+void updatePlanes(SnakeEnv* env, int index, StepResult result) {
+    const BatchSim& sim = env->sim;
+    float* head = planeOf(env, index, PLANE_HEAD);
+    float* body = planeOf(env, index, PLANE_BODY);
+    float* food = planeOf(env, index, PLANE_FOOD);
+
+    int newHead = sim.getSegment(index, 0);
+    head[env->prevHead[index]] = 0.0f;
+    head[newHead] = 1.0f;
+    body[newHead] = 1.0f;
+
+    int tail = env->prevTail[index];
+    if (!sim.isOccupied(index, tail % sim.getCols(), tail / sim.getCols())) {
+        body[tail] = 0.0f;
+    }
+
+    if (result == STEP_ATE) {
+        food[env->prevFood[index]] = 0.0f;
+        food[foodCell(sim, index)] = 1.0f;
+    }
+}
+
+// Ô (x, y) giết rắn ở bước sau: tường, hoặc thân trừ đoạn đuôi sắp rời ô
+bool isDanger(const BatchSim& sim, int index, int x, int y, int tail, bool tailMoves) {
+    if (x < 0 || x >= sim.getCols() || y < 0 || y >= sim.getRows()) {
+        return true;
+    }
+    if (tailMoves && y * sim.getCols() + x == tail) {
+        return false;
+    }
+    return sim.isOccupied(index, x, y);
+}
+
+void writeFeatures(SnakeEnv* env, int index) {
+    const BatchSim& sim = env->sim;
+    float* out = env->obs + static_cast<size_t>(index) * SNAKE_ENV_FEATURE_COUNT;
+
+    int x = sim.getHeadX()[index];
+    int y = sim.getHeadY()[index];
+    int dir = sim.getDirections()[index];
+    int length = sim.getLengths()[index];
+    int tail = sim.getSegment(index, length - 1);
+    bool tailMoves = sim.getSegment(index, length - 2) != tail;
+
+    // Hướng bên phải của UP, DOWN, LEFT, RIGHT; bên trái là hướng ngược lại
+    static const int RIGHT_OF[4] = {RIGHT, LEFT, UP, DOWN};
+    const int dirs[3] = {dir, RIGHT_OF[dir], RIGHT_OF[dir] ^ 1};
+    for (int i = 0; i < 3; i++) {
+        int nx = x + (dirs[i] == RIGHT) - (dirs[i] == LEFT);
+        int ny = y + (dirs[i] == DOWN) - (dirs[i] == UP);
+        out[i] = isDanger(sim, index, nx, ny, tail, tailMoves) ? 1.0f : 0.0f;
+    }
+
+    for (int d = 0; d < 4; d++) {
+        out[3 + d] = dir == d ? 1.0f : 0.0f;
+    }
+
+    int fx = sim.getFoodX()[index];
+    int fy = sim.getFoodY()[index];
+    out[7] = fx < x ? 1.0f : 0.0f;
+    out[8] = fx > x ? 1.0f : 0.0f;
+    out[9] = fy < y ? 1.0f : 0.0f;
+    out[10] = fy > y ? 1.0f : 0.0f;
+}
+
+}
+
+int snake_env_version(void) {
+    return SNAKE_ENV_VERSION;
+}
+
+SnakeEnv* snake_env_create(int n_envs, int board_w, int board_h, uint32_t seed) {
+    if (n_envs <= 0 || !BatchSim::isValidSize(board_w, board_h)) {
+        return nullptr;
+    }
+    // Toàn bộ quan sát dạng mặt phẳng phải đếm được bằng int
+    long long cells = static_cast<long long>(board_w) * board_h;
+    if (static_cast<long long>(n_envs) * cells * SNAKE_ENV_PLANE_COUNT > INT_MAX) {
+        return nullptr;
+    }
+
+    // Các vector bên trong SnakeEnv vẫn cấp phát bằng new thường, và ngoại lệ
+    // không được thoát qua C API
+    SnakeEnv* env = nullptr;
+    try {
+        env = new SnakeEnv(n_envs, board_w, board_h);
+        env->sim.reset(seed);
+    } catch (const std::bad_alloc&) {
+        delete env;
+        return nullptr;
+    }
+    return env;
+}
+
+void snake_env_destroy(SnakeEnv* env) {
+    delete env;
+}
+
+int snake_env_count(const SnakeEnv* env) {
+    return env != nullptr ? env->sim.getCount() : 0;
+}
+
+int snake_env_obs_size(const SnakeEnv* env, int obs_type) {
+    if (env == nullptr || (obs_type != SNAKE_ENV_OBS_PLANES && obs_type != SNAKE_ENV_OBS_FEATURES)) {
+        return SNAKE_ENV_ERROR_ARGUMENT;
+    }
+    return obsSize(env, obs_type);
+}
+
+int snake_env_bind(SnakeEnv* env, int obs_type, float* obs, float* rewards, uint8_t* dones) {
+    if (env == nullptr || obs == nullptr || rewards == nullptr || dones == nullptr ||
+        (obs_type != SNAKE_ENV_OBS_PLANES && obs_type != SNAKE_ENV_OBS_FEATURES)) {
+        return SNAKE_ENV_ERROR_ARGUMENT;
+    }
+
+    env->obsType = obs_type;
+    env->obs = obs;
+    env->rewards = rewards;
+    env->dones = dones;
+
+    // Bộ đệm mới chưa có gì, vẽ toàn bộ trạng thái hiện tại
+    for (int i = 0; i < env->sim.getCount(); i++) {
+        if (obs_type == SNAKE_ENV_OBS_PLANES) {
+            drawPlanes(env, i);
+        } else {
+            writeFeatures(env, i);
+        }
+        rewards[i] = 0.0f;
+        dones[i] = 0;
+    }
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_reset(SnakeEnv* env, uint32_t seed) {
+    if (env == nullptr) {
+        return SNAKE_ENV_ERROR_ARGUMENT;
+    }
+    if (env->obs == nullptr) {
+        return SNAKE_ENV_ERROR_UNBOUND;
+    }
+
+    env->sim.reset(seed);
+    for (int i = 0; i < env->sim.getCount(); i++) {
+        if (env->obsType == SNAKE_ENV_OBS_PLANES) {
+            drawPlanes(env, i);
+        } else {
+            writeFeatures(env, i);
+        }
+        env->rewards[i] = 0.0f;
+        env->dones[i] = 0;
+    }
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_step(SnakeEnv* env, const int32_t* actions) {
+    if (env == nullptr || actions == nullptr) {
+        return SNAKE_ENV_ERROR_ARGUMENT;
+    }
+    if (env->obs == nullptr) {
+        return SNAKE_ENV_ERROR_UNBOUND;
+    }
+
+    BatchSim& sim = env->sim;
+    int count = sim.getCount();
+    bool planes = env->obsType == SNAKE_ENV_OBS_PLANES;
+    for (int i = 0; i < count; i++) {
+        if (actions[i] < SNAKE_ENV_UP || actions[i] > SNAKE_ENV_RIGHT) {
+            return SNAKE_ENV_ERROR_ARGUMENT;
+        }
+        if (planes) {
+            env->prevHead[i] = sim.getSegment(i, 0);
+            env->prevTail[i] = sim.getSegment(i, sim.getLengths()[i] - 1);
+            env->prevFood[i] = foodCell(sim, i);
+        }
+    }
+
+    sim.step(reinterpret_cast<const Direction*>(actions));
+
+    const int8_t* results = sim.getResults();
+    for (int i = 0; i < count; i++) {
+        StepResult result = static_cast<StepResult>(results[i]);
+        bool done = result == STEP_DIED || result == STEP_WON;
+
+        if (result == STEP_ATE || result == STEP_WON) {
+            env->rewards[i] = SNAKE_ENV_REWARD_FOOD;
+        } else if (result == STEP_DIED) {
+            env->rewards[i] = SNAKE_ENV_REWARD_DEATH;
+        } else {
+            env->rewards[i] = 0.0f;
+        }
+        env->dones[i] = done ? 1 : 0;
+
+        if (!planes) {
+            writeFeatures(env, i);
+        } else if (done) {
+            // Ván đã khởi động lại, thân cũ không còn: vẽ lại cả ván
+            drawPlanes(env, i);
+        } else {
+            updatePlanes(env, i, result);
+        }
+    }
+    return SNAKE_ENV_OK;
+}
+
+const int32_t* snake_env_episode_scores(const SnakeEnv* env) {
+    return env != nullptr ? env->sim.getEpisodeScores() : nullptr;
+}
+
+const int32_t* snake_env_episode_lengths(const SnakeEnv* env) {
+    return env != nullptr ? env->sim.getEpisodeTicks() : nullptr;
+}
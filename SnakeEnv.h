@@ -0,0 +1,88 @@
+#ifndef SNAKEENV_H
+#define SNAKEENV_H
+
+#include <stdint.h>
+
+// Thư viện môi trường học tăng cường (snake_env, thư viện động) với C API ổn định,
+// gọi được từ Python (ctypes/cffi) hay C++ mà không cần cửa sổ SDL.
+//
+// Một SnakeEnv chạy n ván độc lập bằng BatchSim (cùng luật với game). Người gọi
+// cấp các bộ đệm liền nhau một lần bằng snake_env_bind(); reset() và step() ghi
+// quan sát, phần thưởng và cờ kết thúc thẳng vào đó, không cấp phát hay sao chép gì thêm.
+// Ván nào kết thúc sẽ tự bắt đầu lại ngay trong step(): done = 1 và quan sát
+// là trạng thái đầu của ván mới.
+
+#if defined(_WIN32)
+#  if defined(SNAKE_ENV_BUILD)
+#    define SNAKE_ENV_API __declspec(dllexport)
+#  else
+#    define SNAKE_ENV_API __declspec(dllimport)
+#  endif
+#else
+#  define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SNAKE_ENV_VERSION 1
+
+// Hành động: giống Direction của game. Quay đầu ngược lại bị bỏ qua.
+#define SNAKE_ENV_UP 0
+#define SNAKE_ENV_DOWN 1
+#define SNAKE_ENV_LEFT 2
+#define SNAKE_ENV_RIGHT 3
+
+// Kiểu quan sát, mỗi ván một khối float liền nhau trong obs:
+//  - PLANES: 3 mặt phẳng [kênh][hàng][cột] (đầu, thân, mồi), giá trị 0 hoặc 1.
+//    step() chỉ ghi lại các ô thay đổi, nên bộ đệm phải giữ nguyên giữa các bước.
+//  - FEATURES: 11 số: nguy hiểm phía trước/bên phải/bên trái, hướng đi (4, one-hot),
+//    mồi ở bên trái/phải/trên/dưới đầu rắn (4).
+#define SNAKE_ENV_OBS_PLANES 0
+#define SNAKE_ENV_OBS_FEATURES 1
+#define SNAKE_ENV_PLANE_COUNT 3
+#define SNAKE_ENV_FEATURE_COUNT 11
+
+// Phần thưởng mỗi bước: +10 khi ăn mồi (như điểm trong game), -10 khi chết
+#define SNAKE_ENV_REWARD_FOOD 10.0f
+#define SNAKE_ENV_REWARD_DEATH -10.0f
+
+// Mã lỗi
+#define SNAKE_ENV_OK 0
+#define SNAKE_ENV_ERROR_ARGUMENT -1
+#define SNAKE_ENV_ERROR_UNBOUND -2
+
+typedef struct SnakeEnv SnakeEnv;
+
+SNAKE_ENV_API int snake_env_version(void);
+
+// board_w * board_h tối đa 65535 ô, board_w >= 4, n_envs * board_w * board_h * 3 không
+// vượt INT_MAX. Trả về NULL nếu tham số sai hoặc không đủ bộ nhớ.
+// Ván thứ i dùng seed + i.
+SNAKE_ENV_API SnakeEnv* snake_env_create(int n_envs, int board_w, int board_h, uint32_t seed);
+SNAKE_ENV_API void snake_env_destroy(SnakeEnv* env);
+
+SNAKE_ENV_API int snake_env_count(const SnakeEnv* env);
+// Số float quan sát của mỗi ván với kiểu obs_type
+SNAKE_ENV_API int snake_env_obs_size(const SnakeEnv* env, int obs_type);
+
+// Gắn bộ đệm của người gọi: obs có n_envs * snake_env_obs_size() float,
+// rewards n_envs float, dones n_envs byte. Bộ đệm phải sống lâu hơn các lần step().
+SNAKE_ENV_API int snake_env_bind(SnakeEnv* env, int obs_type, float* obs, float* rewards, uint8_t* dones);
+
+// Bắt đầu lại mọi ván (seed + i) và ghi quan sát đầu tiên
+SNAKE_ENV_API int snake_env_reset(SnakeEnv* env, uint32_t seed);
+
+// actions có n_envs phần tử SNAKE_ENV_UP..SNAKE_ENV_RIGHT
+SNAKE_ENV_API int snake_env_step(SnakeEnv* env, const int32_t* actions);
+
+// Điểm và số bước của ván vừa kết thúc ở mỗi ván có done = 1 (mảng n_envs phần tử, chỉ đọc)
+SNAKE_ENV_API const int32_t* snake_env_episode_scores(const SnakeEnv* env);
+SNAKE_ENV_API const int32_t* snake_env_episode_lengths(const SnakeEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAKEENV_H
@@ -0,0 +1,156 @@
+#include "SpriteBatch.h"
+#include <iostream>
+
+SpriteBatch::SpriteBatch()
+    : renderer(nullptr), atlas(nullptr), atlasWidth(0), atlasHeight(0), drawCalls(0) {
+}
+
+SpriteBatch::~SpriteBatch() {
+    release();
+}
+
+void SpriteBatch::release() {
+    for (SDL_Surface* surface : pending) {
+        SDL_FreeSurface(surface);
+    }
+    pending.clear();
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+}
+
+int SpriteBatch::addSprite(SDL_Surface* surface, int quarterTurns) {
+    SDL_Surface* source = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!source) {
+        std::cerr << "Không thể chuyển định dạng hình! SDL_Error: " << SDL_GetError() << std::endl;
+        return -1;
+    }
+
+    quarterTurns &= 3;
+    for (int turn = 0; turn < quarterTurns; turn++) {
+        // Xoay 90 độ theo chiều kim đồng hồ: điểm (x, y) của đích lấy từ (y, h - 1 - x) của nguồn
+        SDL_Surface* rotated = SDL_CreateRGBSurfaceWithFormat(0, source->h, source->w, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!rotated) {
+            SDL_FreeSurface(source);
+            return -1;
+        }
+
+        for (int y = 0; y < rotated->h; y++) {
+            Uint32* dest = reinterpret_cast<Uint32*>(static_cast<Uint8*>(rotated->pixels) + y * rotated->pitch);
+            for (int x = 0; x < rotated->w; x++) {
+                const Uint8* row = static_cast<const Uint8*>(source->pixels) + (source->h - 1 - x) * source->pitch;
+                dest[x] = reinterpret_cast<const Uint32*>(row)[y];
+            }
+        }
+
+        SDL_FreeSurface(source);
+        source = rotated;
+    }
+
+    pending.push_back(source);
+    return static_cast<int>(pending.size()) - 1;
+}
+
+bool SpriteBatch::build(SDL_Renderer* renderer) {
+    this->renderer = renderer;
+
+    // Xếp theo hàng, chiều rộng atlas đủ cho hình rộng nhất
+    atlasWidth = 1024;
+    for (SDL_Surface* surface : pending) {
+        if (surface->w + PADDING > atlasWidth) {
+            atlasWidth = surface->w + PADDING;
+        }
+    }
+
+    int penX = 0;
+    int penY = 0;
+    int rowHeight = 0;
+    sources.clear();
+    for (SDL_Surface* surface : pending) {
+        if (penX + surface->w > atlasWidth) {
+            penX = 0;
+            penY += rowHeight + PADDING;
+            rowHeight = 0;
+        }
+
+        sources.push_back(SDL_Rect{penX, penY, surface->w, surface->h});
+        penX += surface->w + PADDING;
+        if (surface->h > rowHeight) {
+            rowHeight = surface->h;
+        }
+    }
+    atlasHeight = penY + rowHeight;
+
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlasSurface) {
+        std::cerr << "Không thể tạo atlas hình! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        SDL_SetSurfaceBlendMode(pending[i], SDL_BLENDMODE_NONE);
+        SDL_Rect dest = sources[i];
+        SDL_BlitSurface(pending[i], nullptr, atlasSurface, &dest);
+        SDL_FreeSurface(pending[i]);
+    }
+    pending.clear();
+
+    atlas = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+
+    if (!atlas) {
+        std::cerr << "Không thể tạo texture atlas! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+    // Đủ cho rắn phủ kín bàn chơi 32x24 mà không cần cấp phát thêm
+    vertices.reserve(4 * 1024);
+    indices.reserve(6 * 1024);
+
+    return true;
+}
+
+void SpriteBatch::draw(int sprite, float x, float y, float w, float h) {
+    const SDL_Rect& source = sources[sprite];
+    drawPart(sprite, SDL_Rect{0, 0, source.w, source.h}, x, y, w, h);
+}
+
+void SpriteBatch::drawPart(int sprite, const SDL_Rect& part, float x, float y, float w, float h) {
+    SDL_Rect source = sources[sprite];
+    source.x += part.x;
+    source.y += part.y;
+    source.w = part.w;
+    source.h = part.h;
+    float u0 = static_cast<float>(source.x) / atlasWidth;
+    float v0 = static_cast<float>(source.y) / atlasHeight;
+    float u1 = static_cast<float>(source.x + source.w) / atlasWidth;
+    float v1 = static_cast<float>(source.y + source.h) / atlasHeight;
+    SDL_Color white = {255, 255, 255, 255};
+
+    int base = static_cast<int>(vertices.size());
+    vertices.push_back(SDL_Vertex{{x, y}, white, {u0, v0}});
+    vertices.push_back(SDL_Vertex{{x + w, y}, white, {u1, v0}});
+    vertices.push_back(SDL_Vertex{{x + w, y + h}, white, {u1, v1}});
+    vertices.push_back(SDL_Vertex{{x, y + h}, white, {u0, v1}});
+
+    indices.push_back(base);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
+    indices.push_back(base);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
+}
+
+void SpriteBatch::flush() {
+    if (indices.empty()) {
+        return;
+    }
+
+    SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+    drawCalls++;
+    vertices.clear();
+    indices.clear();
+}
@@ -0,0 +1,49 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SDL.h>
+#include <vector>
+
+// Gộp nhiều hình vào một texture atlas lúc tải, rồi vẽ cả khung hình
+// bằng một lần SDL_RenderGeometry thay vì mỗi hình một SDL_RenderCopy.
+class SpriteBatch {
+private:
+    static const int PADDING = 2; // Tránh lem màu giữa các hình khi lọc tuyến tính
+
+    SDL_Renderer* renderer;
+    SDL_Texture* atlas;
+    std::vector<SDL_Surface*> pending; // Hình chờ build(), đã đổi sang RGBA32
+    std::vector<SDL_Rect> sources;
+    int atlasWidth;
+    int atlasHeight;
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    int drawCalls;
+
+public:
+    SpriteBatch();
+    ~SpriteBatch();
+
+    // Thêm một hình (xoay quarterTurns lần 90 độ theo chiều kim đồng hồ),
+    // trả về id dùng khi vẽ. surface vẫn thuộc về người gọi.
+    int addSprite(SDL_Surface* surface, int quarterTurns = 0);
+    bool build(SDL_Renderer* renderer);
+    // Giải phóng atlas và các hình chờ build(); phải gọi trước khi hủy renderer
+    void release();
+
+    void draw(int sprite, float x, float y, float w, float h);
+    // Vẽ một phần part (tọa độ trong hình gốc) của hình sprite
+    void drawPart(int sprite, const SDL_Rect& part, float x, float y, float w, float h);
+    void flush();
+
+    // Kích thước gốc của hình (sau khi xoay)
+    int getWidth(int sprite) const { return sources[sprite].w; }
+    int getHeight(int sprite) const { return sources[sprite].h; }
+
+    // Số lần gọi vẽ từ lần resetDrawCalls() gần nhất
+    int getDrawCalls() const { return drawCalls; }
+    void resetDrawCalls() { drawCalls = 0; }
+};
+
+#endif // SPRITEBATCH_H
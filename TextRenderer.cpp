@@ -0,0 +1,190 @@
+#include "TextRenderer.h"
+#include "Profiler.h"
+#include <iostream>
+
+TextRenderer::TextRenderer()
+    : renderer(nullptr), atlas(nullptr),
+      atlasWidth(ATLAS_WIDTH), atlasHeight(0), drawCalls(0) {
+}
+
+TextRenderer::~TextRenderer() {
+    release();
+}
+
+void TextRenderer::release() {
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+}
+
+int TextRenderer::addFont(int size) {
+    FontFace face = {};
+    face.size = size;
+    faces.push_back(face);
+    return static_cast<int>(faces.size()) - 1;
+}
+
+bool TextRenderer::build(SDL_Renderer* renderer, AssetPack& assets, const char* fontName) {
+    PROFILE_SCOPE("buildFontAtlas");
+    this->renderer = renderer;
+
+    // Raster hóa mọi glyph của mọi cỡ chữ, xếp theo hàng vào atlas
+    std::vector<SDL_Surface*> surfaces;
+    int penX = 0;
+    int penY = 0;
+    int rowHeight = 0;
+
+    for (FontFace& face : faces) {
+        TTF_Font* font = TTF_OpenFontRW(assets.openFile(fontName), 1, face.size);
+        if (!font) {
+            std::cerr << "Failed to load font size " << face.size << "! SDL_ttf Error: " << TTF_GetError() << std::endl;
+            for (SDL_Surface* surface : surfaces) {
+                SDL_FreeSurface(surface);
+            }
+            return false;
+        }
+
+        face.height = TTF_FontHeight(font);
+
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            Glyph& glyph = face.glyphs[i];
+            Uint16 ch = static_cast<Uint16>(FIRST_GLYPH + i);
+
+            int minX, maxX, minY, maxY;
+            TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &glyph.advance);
+
+            SDL_Surface* surface = TTF_RenderGlyph_Blended(font, ch, SDL_Color{255, 255, 255, 255});
+            if (!surface) {
+                glyph.source = {0, 0, 0, 0};
+                surfaces.push_back(nullptr);
+                continue;
+            }
+
+            if (penX + surface->w > atlasWidth) {
+                penX = 0;
+                penY += rowHeight + 1;
+                rowHeight = 0;
+            }
+
+            glyph.source = {penX, penY, surface->w, surface->h};
+            penX += surface->w + 1;
+            if (surface->h > rowHeight) {
+                rowHeight = surface->h;
+            }
+            surfaces.push_back(surface);
+        }
+
+        TTF_CloseFont(font);
+    }
+
+    atlasHeight = penY + rowHeight;
+
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlasSurface) {
+        std::cerr << "Failed to create glyph atlas! SDL Error: " << SDL_GetError() << std::endl;
+        for (SDL_Surface* surface : surfaces) {
+            SDL_FreeSurface(surface);
+        }
+        return false;
+    }
+
+    size_t next = 0;
+    for (FontFace& face : faces) {
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            SDL_Surface* surface = surfaces[next++];
+            if (!surface) {
+                continue;
+            }
+
+            // Chép nguyên kênh alpha, không trộn
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+            SDL_Rect dest = face.glyphs[i].source;
+            SDL_BlitSurface(surface, nullptr, atlasSurface, &dest);
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    atlas = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+
+    if (!atlas) {
+        std::cerr << "Failed to create glyph atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+    // Đủ chỗ cho vài trăm ký tự mỗi khung hình mà không cần cấp phát thêm
+    vertices.reserve(4 * 512);
+    indices.reserve(6 * 512);
+
+    return true;
+}
+
+int TextRenderer::measure(int font, const char* text) const {
+    const FontFace& face = faces[font];
+    int width = 0;
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - FIRST_GLYPH;
+        if (index >= 0 && index < GLYPH_COUNT) {
+            width += face.glyphs[index].advance;
+        }
+    }
+    return width;
+}
+
+void TextRenderer::draw(int font, const char* text, int x, int y, SDL_Color color) {
+    const FontFace& face = faces[font];
+    float invWidth = 1.0f / atlasWidth;
+    float invHeight = 1.0f / atlasHeight;
+
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - FIRST_GLYPH;
+        if (index < 0 || index >= GLYPH_COUNT) {
+            continue;
+        }
+
+        const Glyph& glyph = face.glyphs[index];
+        if (glyph.source.w > 0) {
+            float left = static_cast<float>(x);
+            float top = static_cast<float>(y);
+            float right = left + glyph.source.w;
+            float bottom = top + glyph.source.h;
+            float u0 = glyph.source.x * invWidth;
+            float v0 = glyph.source.y * invHeight;
+            float u1 = (glyph.source.x + glyph.source.w) * invWidth;
+            float v1 = (glyph.source.y + glyph.source.h) * invHeight;
+
+            int base = static_cast<int>(vertices.size());
+            vertices.push_back(SDL_Vertex{{left, top}, color, {u0, v0}});
+            vertices.push_back(SDL_Vertex{{right, top}, color, {u1, v0}});
+            vertices.push_back(SDL_Vertex{{right, bottom}, color, {u1, v1}});
+            vertices.push_back(SDL_Vertex{{left, bottom}, color, {u0, v1}});
+
+            indices.push_back(base);
+            indices.push_back(base + 1);
+            indices.push_back(base + 2);
+            indices.push_back(base);
+            indices.push_back(base + 2);
+            indices.push_back(base + 3);
+        }
+
+        x += glyph.advance;
+    }
+}
+
+void TextRenderer::drawCentered(int font, const char* text, int centerX, int y, SDL_Color color) {
+    draw(font, text, centerX - measure(font, text) / 2, y, color);
+}
+
+void TextRenderer::flush() {
+    if (indices.empty()) {
+        return;
+    }
+
+    SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+    drawCalls++;
+    vertices.clear();
+    indices.clear();
+}
@@ -0,0 +1,65 @@
+#ifndef TEXTRENDERER_H
+#define TEXTRENDERER_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <vector>
+
+#include "AssetPack.h"
+
+// Vẽ chữ từ một texture atlas duy nhất chứa glyph ASCII của mọi cỡ chữ.
+// Font chỉ được mở và raster hóa một lần trong build(); sau đó mỗi chuỗi
+// chỉ là các quad thêm vào một lô đỉnh, gửi đi bằng một lần SDL_RenderGeometry
+// trong flush(). Màu chữ nằm ở màu đỉnh nên đổi màu không tốn gì.
+class TextRenderer {
+private:
+    static const int FIRST_GLYPH = 32;
+    static const int GLYPH_COUNT = 95; // ' ' .. '~'
+    static const int ATLAS_WIDTH = 512;
+
+    struct Glyph {
+        SDL_Rect source; // Vị trí trong atlas
+        int advance;
+    };
+
+    struct FontFace {
+        int size;
+        int height;
+        Glyph glyphs[GLYPH_COUNT];
+    };
+
+    SDL_Renderer* renderer;
+    SDL_Texture* atlas;
+    std::vector<FontFace> faces;
+    int atlasWidth;
+    int atlasHeight;
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    int drawCalls;
+
+public:
+    TextRenderer();
+    ~TextRenderer();
+
+    // Đăng ký một cỡ chữ trước build(), trả về id dùng khi vẽ
+    int addFont(int size);
+    bool build(SDL_Renderer* renderer, AssetPack& assets, const char* fontName);
+    // Giải phóng atlas glyph; phải gọi trước khi hủy renderer
+    void release();
+
+    // Kích thước của chuỗi khi vẽ bằng font id
+    int measure(int font, const char* text) const;
+    int getHeight(int font) const { return faces[font].height; }
+
+    void draw(int font, const char* text, int x, int y, SDL_Color color);
+    void drawCentered(int font, const char* text, int centerX, int y, SDL_Color color);
+
+    // Gửi toàn bộ chữ đã xếp hàng trong một lần vẽ
+    void flush();
+
+    int getDrawCalls() const { return drawCalls; }
+    void resetDrawCalls() { drawCalls = 0; }
+};
+
+#endif // TEXTRENDERER_H
@@ -0,0 +1,69 @@
+#include "ThreadPool.h"
+#include <thread>
+
+ThreadPool::ThreadPool(int threadCount)
+    : threadCount(threadCount) {
+    if (this->threadCount <= 0) {
+        this->threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (this->threadCount <= 0) {
+        this->threadCount = 1;
+    }
+
+    for (int i = 0; i < this->threadCount; i++) {
+        queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+}
+
+bool ThreadPool::popLocal(int worker, int& task) {
+    WorkQueue& queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int thief, int& task) {
+    for (int i = 1; i < threadCount; i++) {
+        WorkQueue& queue = *queues[(thief + i) % threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::work(int worker, const std::function<void(int, int)>& fn) {
+    int task;
+    // Không có việc mới sinh ra trong lúc chạy, nên hết việc ở mọi hàng là xong
+    while (popLocal(worker, task) || steal(worker, task)) {
+        fn(task, worker);
+    }
+}
+
+void ThreadPool::parallelFor(int taskCount, const std::function<void(int, int)>& fn) {
+    // Chia trước thành các khối liên tiếp, mỗi luồng một khối
+    for (int worker = 0; worker < threadCount; worker++) {
+        int begin = static_cast<int>(static_cast<long long>(taskCount) * worker / threadCount);
+        int end = static_cast<int>(static_cast<long long>(taskCount) * (worker + 1) / threadCount);
+        for (int task = end - 1; task >= begin; task--) {
+            queues[worker]->tasks.push_back(task);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < threadCount; worker++) {
+        threads.emplace_back(&ThreadPool::work, this, worker, std::cref(fn));
+    }
+    work(0, fn);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Nhóm luồng chia việc kiểu work-stealing: mỗi luồng có hàng đợi riêng,
+// lấy việc từ cuối hàng của mình và khi hết việc thì "trộm" từ đầu hàng
+// của luồng khác. Các việc có độ dài khác nhau (ván ngắn/dài) vẫn chia đều.
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    int threadCount;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    bool popLocal(int worker, int& task);
+    bool steal(int thief, int& task);
+    void work(int worker, const std::function<void(int, int)>& fn);
+
+public:
+    // threadCount = 0: dùng tất cả lõi CPU
+    explicit ThreadPool(int threadCount = 0);
+
+    int getThreadCount() const { return threadCount; }
+
+    // Gọi fn(task, worker) cho mọi task trong [0, taskCount), chờ đến khi xong hết
+    void parallelFor(int taskCount, const std::function<void(int, int)>& fn);
+};
+
+#endif // THREADPOOL_H
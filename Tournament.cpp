@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Agent.h"
+#include "GameSim.h"
+#include "ThreadPool.h"
+
+// snake_tournament: cho các agent chơi trên cùng một bộ seed, chạy song song
+// trên mọi lõi CPU rồi ghi thống kê theo từng agent (CSV).
+//
+//   snake_tournament [--agents greedy,random] [--seeds 1000] [--first-seed 1]
+//                    [--threads 0] [--cols 32] [--rows 24] [--max-ticks N] [--out file.csv]
+
+namespace {
+
+struct MatchResult {
+    int score;
+    int ticks;
+    bool won;
+    double seconds;
+};
+
+struct Options {
+    std::vector<std::string> agents;
+    int seeds;
+    unsigned int firstSeed;
+    int threads;
+    int cols;
+    int rows;
+    int maxTicks;
+    std::string out;
+    bool help;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Cách dùng: snake_tournament [--agents greedy,random] [--seeds 1000] [--first-seed 1]\n"
+        << "                        [--threads 0] [--cols 32] [--rows 24] [--max-ticks N] [--out file.csv]\n"
+        << "  --threads 0: dùng mọi lõi CPU; --max-ticks mặc định (cols * rows)^2\n"
+        << "  Agent:";
+    for (const std::string& name : getAgentNames()) {
+        out << ' ' << name;
+    }
+    out << std::endl;
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+bool parseOptions(int argc, char* args[], Options& options) {
+    options.agents = getAgentNames();
+    options.seeds = 1000;
+    options.firstSeed = 1;
+    options.threads = 0;
+    options.cols = 32;
+    options.rows = 24;
+    options.maxTicks = 0;
+    options.help = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            options.help = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Thiếu giá trị cho " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = args[++i];
+        if (arg == "--agents") {
+            options.agents = split(value, ',');
+        } else if (arg == "--seeds") {
+            options.seeds = atoi(value.c_str());
+        } else if (arg == "--first-seed") {
+            options.firstSeed = static_cast<unsigned int>(strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--threads") {
+            options.threads = atoi(value.c_str());
+        } else if (arg == "--cols") {
+            options.cols = atoi(value.c_str());
+        } else if (arg == "--rows") {
+            options.rows = atoi(value.c_str());
+        } else if (arg == "--max-ticks") {
+            options.maxTicks = atoi(value.c_str());
+        } else if (arg == "--out") {
+            options.out = value;
+        } else {
+            std::cerr << "Tham số không hợp lệ: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    // Cùng điều kiện với --world của game: rắn ban đầu dài 3 ô nằm giữa bàn cần ít
+    // nhất 4 cột. Mỗi (agent, seed) là một ván đánh chỉ số bằng int.
+    long long cells = static_cast<long long>(options.cols) * options.rows;
+    long long matches = static_cast<long long>(options.agents.size()) * options.seeds;
+    if (options.seeds <= 0 || options.cols < 4 || options.rows < 1 || cells > GameSim::MAX_CELLS ||
+        matches > INT_MAX) {
+        return false;
+    }
+
+    if (options.maxTicks <= 0) {
+        // Agent có thể đi vòng mãi mà không chết, nên giới hạn độ dài ván. Đi theo chu
+        // trình Hamilton thì mỗi mồi mất tối đa cols * rows bước, nên giới hạn phải đủ
+        // cho (cols * rows)^2 bước thì autopilot mới có thể thắng
+        options.maxTicks = static_cast<int>(std::min<long long>(cells * cells, INT_MAX));
+    }
+    return true;
+}
+
+MatchResult playMatch(Agent& agent, unsigned int seed, const Options& options) {
+    // Kích thước ô = 1 nên tọa độ điểm ảnh trùng với tọa độ ô
+    GameSim sim(1, options.cols, options.rows);
+    sim.reset(seed);
+    agent.reset(seed);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    StepResult result = STEP_NONE;
+    while (!sim.isOver() && sim.getTick() < options.maxTicks) {
+        result = sim.step(agent.decide(sim));
+    }
+
+    MatchResult match;
+    match.score = sim.getScore();
+    match.ticks = sim.getTick();
+    match.won = (result == STEP_WON);
+    match.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return match;
+}
+
+int percentile(const std::vector<int>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+}
+
+int main(int argc, char* args[]) {
+    Options options;
+    if (!parseOptions(argc, args, options)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(std::cout);
+        return 0;
+    }
+
+    for (const std::string& name : options.agents) {
+        if (!createAgent(name)) {
+            std::cerr << "Không có agent: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    // Mỗi (agent, seed) là một ván; kết quả ghi theo chỉ số nên không phụ thuộc số luồng
+    int agentCount = static_cast<int>(options.agents.size());
+    int matchCount = agentCount * options.seeds; // parseOptions() đã kiểm tra tràn số
+    std::vector<MatchResult> results(matchCount);
+
+    ThreadPool pool(options.threads);
+    std::vector<std::vector<std::unique_ptr<Agent>>> agents(pool.getThreadCount());
+    for (std::vector<std::unique_ptr<Agent>>& workerAgents : agents) {
+        for (const std::string& name : options.agents) {
+            workerAgents.push_back(createAgent(name));
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pool.parallelFor(matchCount, [&](int match, int worker) {
+        int agent = match / options.seeds;
+        unsigned int seed = options.firstSeed + match % options.seeds;
+        results[match] = playMatch(*agents[worker][agent], seed, options);
+    });
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out.c_str());
+        if (!file) {
+            std::cerr << "Không thể ghi file " << options.out << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.out.empty() ? std::cout : file;
+
+    out << "agent,matches,wins,mean_score,p50_score,p90_score,p99_score,max_score,"
+        << "mean_ticks,p50_ticks,p99_ticks,ticks_per_sec\n";
+
+    long long totalTicks = 0;
+    for (int agent = 0; agent < agentCount; agent++) {
+        std::vector<int> scores;
+        std::vector<int> ticks;
+        long long scoreSum = 0;
+        long long tickSum = 0;
+        double seconds = 0;
+        int wins = 0;
+
+        for (int i = 0; i < options.seeds; i++) {
+            const MatchResult& match = results[agent * options.seeds + i];
+            scores.push_back(match.score);
+            ticks.push_back(match.ticks);
+            scoreSum += match.score;
+            tickSum += match.ticks;
+            seconds += match.seconds;
+            wins += match.won ? 1 : 0;
+        }
+        totalTicks += tickSum;
+
+        std::sort(scores.begin(), scores.end());
+        std::sort(ticks.begin(), ticks.end());
+
+        out << options.agents[agent] << ',' << options.seeds << ',' << wins << ','
+            << static_cast<double>(scoreSum) / options.seeds << ','
+            << percentile(scores, 0.50) << ',' << percentile(scores, 0.90) << ','
+            << percentile(scores, 0.99) << ',' << scores.back() << ','
+            << static_cast<double>(tickSum) / options.seeds << ','
+            << percentile(ticks, 0.50) << ',' << percentile(ticks, 0.99) << ','
+            << (seconds > 0 ? static_cast<long long>(tickSum / seconds) : 0) << '\n';
+    }
+
+    std::cerr << matchCount << " ván, " << totalTicks << " bước, "
+              << pool.getThreadCount() << " luồng, " << wallSeconds << " s ("
+              << static_cast<long long>(totalTicks / wallSeconds) << " bước/s)" << std::endl;
+
+    return 0;
+}
@@ -1,8 +1,93 @@
 #include <SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
 #include "Game.h"
+#include "Profiler.h"
 
 int main(int argc, char* args[]) {
     Game game;
+    bool worldSet = false;
+    bool arenaSet = false;
+    int latency = 0;
+    int jitter = 0;
+    double loss = 0;
+
+    // --vsync: vẽ theo tần số màn hình, --uncapped: không giới hạn khung hình
+    // --software: dùng renderer phần mềm, --incremental: chỉ vẽ lại phần thay đổi
+    // --loose: đọc tệp rời thay vì assets/assets.pak
+    // --replay <file>: xem lại một ván đã ghi
+    // --world <cột>x<hàng>: bàn chơi lớn hơn cửa sổ, camera đi theo đầu rắn
+    //                       (trên Replay::MAX_CELLS ô thì không ghi replay)
+    // --arena <số bot>: chơi cùng nhiều rắn máy (mặc định trên bàn 256x256)
+    // --trace <file.json>: ghi trace_event của cả phiên (chỉ bản SNAKE_PROFILE)
+    // --duel-host <cổng>, --duel-join <máy>:<cổng>: đấu tay đôi qua mạng với rollback
+    // --net-latency <ms> --net-jitter <ms> --net-loss <0..1>: giả lập đường truyền xấu khi đấu tay đôi
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--vsync") == 0) {
+            game.setFrameCap(FRAME_CAP_VSYNC);
+        } else if (strcmp(args[i], "--uncapped") == 0) {
+            game.setFrameCap(FRAME_CAP_NONE);
+        } else if (strcmp(args[i], "--software") == 0) {
+            game.setSoftwareRenderer(true);
+        } else if (strcmp(args[i], "--incremental") == 0) {
+            game.setIncremental(true);
+        } else if (strcmp(args[i], "--loose") == 0) {
+            game.setLooseAssets(true);
+        } else if (strcmp(args[i], "--world") == 0 && i + 1 < argc) {
+            int cols = 0;
+            int rows = 0;
+            i++;
+            // Rắn ban đầu nằm giữa bàn và dài 3 ô nên cần ít nhất 4 cột
+            if (sscanf(args[i], "%dx%d", &cols, &rows) != 2 || cols < 4 || rows < 1 ||
+                static_cast<long long>(cols) * rows > GameSim::MAX_CELLS) {
+                std::cerr << "Kích thước bàn chơi không hợp lệ: " << args[i] << std::endl;
+                return 1;
+            }
+            game.setWorldSize(cols, rows);
+            worldSet = true;
+        } else if (strcmp(args[i], "--arena") == 0 && i + 1 < argc) {
+            int bots = atoi(args[++i]);
+            if (bots < 1) {
+                std::cerr << "Số bot không hợp lệ: " << args[i] << std::endl;
+                return 1;
+            }
+            game.setArena(bots);
+            arenaSet = true;
+        } else if (strcmp(args[i], "--duel-host") == 0 && i + 1 < argc) {
+            game.setDuelHost(atoi(args[++i]));
+        } else if (strcmp(args[i], "--duel-join") == 0 && i + 1 < argc) {
+            std::string target = args[++i];
+            size_t colon = target.rfind(':');
+            if (colon == std::string::npos || atoi(target.c_str() + colon + 1) <= 0) {
+                std::cerr << "Cần dạng <máy>:<cổng>: " << target << std::endl;
+                return 1;
+            }
+            game.setDuelJoin(target.substr(0, colon), atoi(target.c_str() + colon + 1));
+        } else if (strcmp(args[i], "--net-latency") == 0 && i + 1 < argc) {
+            latency = atoi(args[++i]);
+        } else if (strcmp(args[i], "--net-jitter") == 0 && i + 1 < argc) {
+            jitter = atoi(args[++i]);
+        } else if (strcmp(args[i], "--net-loss") == 0 && i + 1 < argc) {
+            loss = atof(args[++i]);
+        } else if (strcmp(args[i], "--replay") == 0 && i + 1 < argc) {
+            game.setReplayFile(args[++i]);
+        } else if (strcmp(args[i], "--trace") == 0 && i + 1 < argc) {
+#ifdef SNAKE_PROFILE
+            Profiler::startTrace(args[++i]);
+#else
+            std::cerr << "--trace cần bản biên dịch với SNAKE_PROFILE (target Profile)" << std::endl;
+            i++;
+#endif
+        }
+    }
+
+    if (arenaSet && !worldSet) {
+        game.setWorldSize(256, 256);
+    }
+    game.setNetworkConditions(latency, jitter, loss);
 
     if (!game.init()) {
         return 1;
@@ -10,5 +95,9 @@ int main(int argc, char* args[]) {
 
     game.run();
 
+#ifdef SNAKE_PROFILE
+    Profiler::writeTrace();
+#endif
+
     return 0;
 }